@@ -1,35 +1,21 @@
 #include <iostream>
-#include <fstream>
+#include <string>
+#include "../01/calibration.hpp"
+#include "../common/input.hpp"
+#include "../common/pipeline.hpp"
 
 int main() {
-    std::ifstream inputFile("input");
+    aoc::mapped_file inputFile("input");
 
     if (inputFile.is_open()) {
-        std::string line;
         int sum = 0;
 
-        while (getline(inputFile, line)) {
-            std::pair<char, char> nums;
-
-            for (auto c : line) {
-                if (isdigit(c)) {
-                    nums.first = c;
-                    break;
-                }
-            }
-            for (auto c = line.rbegin(); c != line.rend(); ++c) {
-                if (isdigit(*c)) {
-                    nums.second = *c;
-                    break;
-                }
-            }
-
-            std::string num = {nums.first, nums.second};
-            sum += std::stoi(num);
-        }
+        // lines are independent, so they're summed in whatever order they parse
+        aoc::pipeline(inputFile.view(), [](std::string_view line, aoc::arena &) {
+            return day01::digits(line, false).value();
+        }, [&sum](int value) { sum += value; }, {.ordered = false});
 
         std::cout << sum << std::endl;
-        inputFile.close();
     }
 
     return 0;
@@ -0,0 +1,169 @@
+#pragma once
+#include "../common/input.hpp"
+#include "../common/instrument.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+// Calibration values, written to run in constant expressions as well as at
+// run time. Part 1 reads only digits; part 2 also reads digits spelled out,
+// which may overlap, as in "eightwo".
+namespace day01 {
+// Keys cached answers; see aoc::cache::key before bumping.
+inline constexpr int version = 1;
+
+namespace detail {
+constexpr std::array<std::string_view, 9> spelled = {
+    "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+
+// An Aho-Corasick automaton over the spelled digits, built at compile time.
+// A state is the longest prefix of a word that the text read so far ends
+// with, so one letter is one table lookup and overlapping words such as
+// "eightwo" are both found. The backward automaton is built from the words
+// reversed, for reading a line from its end.
+struct automaton {
+  static constexpr std::size_t letters = 26;
+  // the root and one state per letter of every word, which is more than the
+  // distinct prefixes need
+  static constexpr std::size_t states = 1 + 36;
+
+  // next[state][letter], for lowercase letters; anything else goes to 0
+  std::array<std::array<std::uint8_t, letters>, states> next{};
+  // the digit spelled by the word the state completes, or 0
+  std::array<std::uint8_t, states> digit{};
+
+  // Takes a letter; returns the digit whose word ends with it, or 0.
+  constexpr int step(std::uint8_t &state, char c) const {
+    if (c < 'a' || c > 'z') {
+      state = 0;
+      return 0;
+    }
+
+    state = this->next[state][c - 'a'];
+    return this->digit[state];
+  }
+};
+
+constexpr automaton build(bool backward) {
+  automaton out;
+  std::size_t used = 1;
+  for (std::size_t i = 0; i < spelled.size(); ++i) {
+    auto word = spelled[i];
+    std::uint8_t state = 0;
+    for (std::size_t j = 0; j < word.size(); ++j) {
+      char c = backward ? word[word.size() - 1 - j] : word[j];
+      auto &to = out.next[state][c - 'a'];
+      if (to == 0) {
+        to = static_cast<std::uint8_t>(used++);
+      }
+      state = to;
+    }
+    out.digit[state] = static_cast<std::uint8_t>(i + 1);
+  }
+
+  // Breadth first from the root, so a state's failure link (the longest
+  // proper suffix that is also a prefix) is shallower and already complete.
+  // Missing transitions are copied from it, which turns the trie into the
+  // automaton.
+  std::array<std::uint8_t, automaton::states> fail{}, queue{};
+  std::size_t head = 0, tail = 0;
+  for (auto to : out.next[0]) {
+    if (to != 0) {
+      queue[tail++] = to;
+    }
+  }
+  while (head < tail) {
+    auto state = queue[head++];
+    if (out.digit[state] == 0) {
+      out.digit[state] = out.digit[fail[state]];
+    }
+
+    for (std::size_t c = 0; c < automaton::letters; ++c) {
+      auto &to = out.next[state][c];
+      if (to != 0) {
+        fail[to] = out.next[fail[state]][c];
+        queue[tail++] = to;
+      } else {
+        to = out.next[fail[state]][c];
+      }
+    }
+  }
+
+  return out;
+}
+
+inline constexpr automaton forward = build(false);
+inline constexpr automaton backward = build(true);
+
+constexpr int digit(char c) { return c >= '0' && c <= '9' ? c - '0' : -1; }
+} // namespace detail
+
+// The first and last digits of a line, which are the same digit when it
+// holds only one.
+struct Digits {
+  int first;
+  int last;
+
+  constexpr int value() const { return first * 10 + last; }
+};
+
+// Throws std::runtime_error on a line without a digit. With words, each end
+// of the line is read by its automaton until a digit or a word is complete.
+constexpr Digits digits(std::string_view line, bool words) {
+  Digits out{-1, -1};
+  std::uint8_t state = 0;
+  for (std::size_t at = 0; at < line.size() && out.first < 0; ++at) {
+    if (auto d = detail::digit(line[at]); d >= 0) {
+      out.first = d;
+    } else if (words) {
+      if (auto w = detail::forward.step(state, line[at]); w > 0) {
+        out.first = w;
+      }
+    }
+  }
+
+  state = 0;
+  for (std::size_t at = line.size(); at-- > 0 && out.last < 0;) {
+    if (auto d = detail::digit(line[at]); d >= 0) {
+      out.last = d;
+    } else if (words) {
+      if (auto w = detail::backward.step(state, line[at]); w > 0) {
+        out.last = w;
+      }
+    }
+  }
+
+  if (out.first < 0) {
+    throw std::runtime_error("no digit on line");
+  }
+  return out;
+}
+
+constexpr int sum(std::string_view input, bool words) {
+  int total = 0;
+  for (auto line : aoc::lines(input)) {
+    total += digits(line, words).value();
+  }
+  return total;
+}
+
+// Timed like the other days' parts when run, which a constant expression
+// can't be.
+constexpr int part1(std::string_view input) {
+  if (std::is_constant_evaluated()) {
+    return sum(input, false);
+  }
+  return AOC_TIMED("01/part1", sum(input, false));
+}
+
+constexpr int part2(std::string_view input) {
+  if (std::is_constant_evaluated()) {
+    return sum(input, true);
+  }
+  return AOC_TIMED("01/part2", sum(input, true));
+}
+} // namespace day01
@@ -0,0 +1,185 @@
+#include "lib.hpp"
+#include "../common/instrument.hpp"
+
+#include <lexy/action/parse.hpp>
+#include <lexy/callback/container.hpp>
+#include <lexy/callback/fold.hpp>
+#include <lexy/callback/object.hpp>
+#include <lexy/dsl.hpp>
+#include <lexy/input/string_input.hpp>
+#include <lexy_ext/report_error.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace day02 {
+namespace {
+// The parse state: the arena's allocator for the rounds, and where finished
+// games go.
+struct state {
+  aoc::arena::allocator_type allocator;
+  const std::function<void(Game &&)> *on_game;
+};
+
+// A list sink that hands each game to the state's on_game instead of keeping
+// it, and counts them. Blank and bad lines give it nothing.
+struct to_on_game {
+  using return_type = std::size_t;
+
+  // an input with no lines at all
+  constexpr std::size_t operator()(lexy::nullopt) const { return 0; }
+
+  struct callback {
+    using return_type = std::size_t;
+
+    const std::function<void(Game &&)> *on_game;
+    std::size_t games = 0;
+
+    void operator()() {}
+    void operator()(Game &&game) {
+      (*this->on_game)(std::move(game));
+      ++this->games;
+    }
+
+    std::size_t finish() && { return this->games; }
+  };
+
+  callback sink(const state &parse) const { return {parse.on_game}; }
+};
+
+namespace grammar {
+namespace dsl = lexy::dsl;
+
+struct round {
+  static constexpr auto entities = lexy::symbol_table<char>
+                                       .map<LEXY_SYMBOL("red")>('r')
+                                       .map<LEXY_SYMBOL("green")>('g')
+                                       .map<LEXY_SYMBOL("blue")>('b');
+
+  static constexpr auto rule = dsl::list(
+      dsl::integer<int>(dsl::digits<>) + dsl::ascii::space +
+          dsl::symbol<entities>(dsl::identifier(dsl::ascii::alpha)),
+      dsl::sep(LEXY_LIT(", ")));
+
+  static constexpr auto value = lexy::fold_inplace<Round>(
+      Round{0, 0, 0}, [](Round &round, int n, char kw) {
+        switch (kw) {
+        case 'r':
+          round.red = n;
+          break;
+        case 'g':
+          round.green = n;
+          break;
+        case 'b':
+          round.blue = n;
+          break;
+        }
+      });
+};
+
+struct rounds {
+  static constexpr auto rule =
+      dsl::list(dsl::p<round>, dsl::sep(LEXY_LIT("; ")));
+  static constexpr auto value =
+      lexy::as_list<std::pmr::vector<Round>>.allocator(&state::allocator);
+};
+
+struct game {
+  static constexpr auto rule = LEXY_LIT("Game") + dsl::ascii::space +
+                               dsl::integer<int>(dsl::digits<>) +
+                               dsl::colon + dsl::ascii::space +
+                               dsl::p<rounds> + dsl::eol;
+
+  static constexpr auto value = lexy::construct<Game>;
+};
+
+// Every line of the input in one parse, so errors are reported against their
+// line in the file. A bad line is recovered from by skipping the rest of it,
+// which leaves the games on either side intact.
+struct games {
+  static constexpr auto line =
+      dsl::newline | dsl::else_ >> dsl::try_(dsl::p<game>,
+                                             dsl::until(dsl::newline).or_eof());
+
+  static constexpr auto rule = dsl::terminator(dsl::eof).opt_list(line);
+  static constexpr auto value = to_on_game{};
+};
+} // namespace grammar
+} // namespace
+
+std::size_t each_game(std::string_view input, aoc::arena &arena,
+                      const std::function<void(Game &&)> &on_game) {
+  AOC_SCOPE("02/parse");
+  auto result = lexy::parse<grammar::games>(lexy::string_input(input),
+                                            state{arena.allocator(), &on_game},
+                                            lexy_ext::report_error);
+  return result.error_count();
+}
+
+Games parse(std::string_view input, aoc::arena &arena) {
+  Games games(arena.allocator());
+  if (each_game(input, arena,
+                [&games](Game &&game) { games.push_back(std::move(game)); }) >
+      0) {
+    throw std::runtime_error("failed to parse");
+  }
+
+  return games;
+}
+
+bool possible(const Game &game) {
+  constexpr int total_red = 12;
+  constexpr int total_green = 13;
+  constexpr int total_blue = 14;
+
+  return std::ranges::all_of(game.rounds, [](const Round &round) {
+    return round.red <= total_red && round.green <= total_green &&
+           round.blue <= total_blue;
+  });
+}
+
+long power(const Game &game) {
+  Round most{0, 0, 0};
+  for (const auto &round : game.rounds) {
+    most.red = std::max(most.red, round.red);
+    most.green = std::max(most.green, round.green);
+    most.blue = std::max(most.blue, round.blue);
+  }
+
+  return static_cast<long>(most.red) * most.green * most.blue;
+}
+
+long part1(const Games &games) {
+  AOC_SCOPE("02/part1");
+  long sum = 0;
+  for (const auto &game : games) {
+    if (possible(game)) {
+      sum += game.id;
+    }
+  }
+
+  return sum;
+}
+
+long part2(const Games &games) {
+  AOC_SCOPE("02/part2");
+  long sum = 0;
+  for (const auto &game : games) {
+    sum += power(game);
+  }
+
+  return sum;
+}
+
+long part1(std::string_view input) {
+  aoc::arena arena;
+  return part1(parse(input, arena));
+}
+
+long part2(std::string_view input) {
+  aoc::arena arena;
+  return part2(parse(input, arena));
+}
+} // namespace day02
@@ -0,0 +1,51 @@
+#pragma once
+#include "../common/arena.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace day02 {
+// Keys cached answers; see aoc::cache::key before bumping.
+inline constexpr int version = 1;
+
+// The cubes of each colour shown in one handful; a colour not named is 0.
+struct Round {
+  int red;
+  int blue;
+  int green;
+};
+
+struct Game {
+  int id;
+  std::pmr::vector<Round> rounds;
+};
+
+using Games = std::pmr::vector<Game>;
+
+// Parses the whole input in one pass, handing each game to on_game as soon
+// as it is read; its rounds are in the arena, which must outlive them. A line
+// that isn't a game is reported on stderr with its line number and skipped,
+// and parsing carries on with the next line. Blank lines are skipped too.
+// Returns the number of bad lines.
+std::size_t each_game(std::string_view input, aoc::arena &arena,
+                      const std::function<void(Game &&)> &on_game);
+
+// Every game in the input, in order; throws if any line is bad.
+Games parse(std::string_view input, aoc::arena &arena);
+
+// Whether the bag of 12 red, 13 green and 14 blue cubes could have given
+// every round of the game.
+bool possible(const Game &game);
+// The product of the fewest cubes of each colour the game could be played
+// with.
+long power(const Game &game);
+
+// The sum of the possible games' ids, and of every game's power.
+long part1(const Games &games);
+long part2(const Games &games);
+long part1(std::string_view input);
+long part2(std::string_view input);
+} // namespace day02
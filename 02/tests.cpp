@@ -0,0 +1,48 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "lib.hpp"
+#include <doctest/doctest.h>
+#include <vector>
+
+using namespace day02;
+
+constexpr auto example = R"EOF(
+Game 1: 3 blue, 4 red; 1 red, 2 green, 6 blue; 2 green
+Game 2: 1 blue, 2 green; 3 green, 4 blue, 1 red; 1 green, 1 blue
+Game 3: 8 green, 6 blue, 20 red; 5 blue, 4 red, 13 green; 5 green, 1 red
+Game 4: 1 green, 3 red, 6 blue; 3 green, 6 red; 3 green, 15 blue, 14 red
+Game 5: 6 red, 1 blue, 3 green; 2 blue, 1 red, 2 green
+)EOF";
+
+TEST_CASE("02-parts") {
+  CHECK(part1(1 + example) == 8);
+  CHECK(part2(1 + example) == 2286);
+}
+
+TEST_CASE("02-parse") {
+  aoc::arena arena;
+  auto games = parse(1 + example, arena);
+  REQUIRE(games.size() == 5);
+  CHECK(games[2].id == 3);
+  REQUIRE(games[2].rounds.size() == 3);
+  CHECK(games[2].rounds[0].red == 20);
+  CHECK(games[2].rounds[0].green == 8);
+  CHECK(power(games[0]) == 48);
+
+  // no trailing newline, and blank lines between games
+  CHECK(parse("Game 1: 1 red", arena).size() == 1);
+  CHECK(parse("Game 1: 1 red\n\nGame 2: 2 blue\n\n", arena).size() == 2);
+  CHECK(parse("", arena).empty());
+
+  CHECK_THROWS(parse("Game 1: 1 red\nGame 2: 2 purple\n", arena));
+}
+
+TEST_CASE("02-recovery") {
+  // a bad line is skipped and the games around it still count
+  aoc::arena arena;
+  std::vector<int> ids;
+  auto bad = each_game("Game 1: 1 red\nGame 2: 2 purple\nnot a game\n"
+                       "Game 4: 4 blue\n",
+                       arena, [&ids](Game &&game) { ids.push_back(game.id); });
+  CHECK(bad == 2);
+  CHECK(ids == std::vector{1, 4});
+}
@@ -0,0 +1,399 @@
+#include "lib.hpp"
+#include "../common/input.hpp"
+#include "../common/instrument.hpp"
+#include "../common/integer.hpp"
+#include "../common/snapshot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace day03 {
+namespace {
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+bool is_symbol(char c) {
+  return c != '.' && !is_digit(c) && !(c >= 'a' && c <= 'z') &&
+         !(c >= 'A' && c <= 'Z');
+}
+
+// The first digit of the number that `digit` is part of. The halo ends every
+// row in a '.', so the scan needs no bound.
+const char *number_start(const char *digit) {
+  while (is_digit(digit[-1])) {
+    --digit;
+  }
+  return digit;
+}
+
+long number_at(const char *start) {
+  long value = 0;
+  for (; is_digit(*start); ++start) {
+    value = value * 10 + (*start - '0');
+  }
+  return value;
+}
+
+// Whether a symbol touches the number of length digits from (x, y). The box
+// around it, halo included, is read as three runs of cells.
+bool is_part(const Schematic &schematic, std::ptrdiff_t x, std::ptrdiff_t y,
+             std::size_t length) {
+  for (std::ptrdiff_t dy = -1; dy <= 1; ++dy) {
+    if (std::ranges::any_of(schematic.run(x - 1, y + dy, length + 2),
+                            is_symbol)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The product of the numbers around a gear when there are exactly two of
+// them, and otherwise 0.
+long ratio(const Schematic &schematic, const char *gear) {
+  // neighbours come row by row, so digits of one number are adjacent in the
+  // order and only need comparing with the last number found
+  std::array<const char *, 8> numbers;
+  std::size_t found = 0;
+  for (auto offset : schematic.neighbours()) {
+    auto cell = gear + offset;
+    if (!is_digit(*cell)) {
+      continue;
+    }
+
+    auto start = number_start(cell);
+    if (found == 0 || numbers[found - 1] != start) {
+      numbers[found++] = start;
+    }
+  }
+
+  return found == 2 ? number_at(numbers[0]) * number_at(numbers[1]) : 0;
+}
+
+// The rows of a text schematic or of a snapshot, which are read in place,
+// straight out of the mapping.
+std::vector<std::string_view> rows_of(std::string_view input) {
+  std::vector<std::string_view> rows;
+  if (aoc::snapshot::is_snapshot(input)) {
+    auto grid = aoc::snapshot::read_grid(input, "03");
+    for (std::size_t y = 0; y < grid.height; ++y) {
+      rows.push_back(grid.row(y));
+    }
+  } else {
+    for (auto line : aoc::lines(input)) {
+      rows.push_back(line);
+    }
+  }
+
+  auto width = rows.empty() ? 0 : rows.front().size();
+  if (std::ranges::any_of(rows, [width](auto row) {
+        return row.size() != width;
+      })) {
+    throw std::runtime_error("schematic rows differ in length");
+  }
+
+  return rows;
+}
+} // namespace
+
+Schematic parse(std::string_view input) {
+  AOC_SCOPE("03/parse");
+  auto rows = rows_of(input);
+  auto width = rows.empty() ? 0 : rows.front().size();
+  Schematic schematic(width, rows.size(), '.');
+  for (std::size_t y = 0; y < rows.size(); ++y) {
+    std::ranges::copy(rows[y], schematic.row(y).begin());
+  }
+
+  return schematic;
+}
+
+long part1(const Schematic &schematic) {
+  AOC_SCOPE("03/part1");
+  long sum = 0;
+  for (std::size_t y = 0; y < schematic.height(); ++y) {
+    auto row = schematic.row(y);
+    for (std::size_t x = 0; x < row.size();) {
+      if (!is_digit(row[x])) {
+        ++x;
+        continue;
+      }
+
+      auto start = x;
+      while (x < row.size() && is_digit(row[x])) {
+        ++x;
+      }
+
+      if (is_part(schematic, start, y, x - start)) {
+        sum += number_at(row.data() + start);
+      }
+    }
+  }
+
+  return sum;
+}
+
+long part2(const Schematic &schematic) {
+  AOC_SCOPE("03/part2");
+  long sum = 0;
+  for (std::size_t y = 0; y < schematic.height(); ++y) {
+    auto row = schematic.row(y);
+    for (auto gear = std::ranges::find(row, '*'); gear != row.end();
+         gear = std::find(gear + 1, row.end(), '*')) {
+      sum += ratio(schematic, &*gear);
+    }
+  }
+
+  return sum;
+}
+
+Editor::Editor(Schematic schematic) : cells(std::move(schematic)) {
+  AOC_SCOPE("03/editor");
+  this->parts = day03::part1(this->cells);
+  this->ratios = day03::part2(this->cells);
+}
+
+void Editor::check(std::size_t x, std::size_t y) const {
+  if (x >= this->cells.width() || y >= this->cells.height()) {
+    throw std::out_of_range("cell is outside the schematic");
+  }
+}
+
+char Editor::get(std::size_t x, std::size_t y) const {
+  this->check(x, y);
+  return this->cells.cell(x, y);
+}
+
+std::vector<const char *> Editor::numbers_around(std::size_t x,
+                                                 std::size_t y) const {
+  std::vector<const char *> numbers;
+  auto center = this->cells.data(x, y);
+  auto note = [&numbers](const char *cell) {
+    if (is_digit(*cell)) {
+      numbers.push_back(number_start(cell));
+    }
+  };
+
+  note(center);
+  for (auto offset : this->cells.neighbours()) {
+    note(center + offset);
+  }
+
+  std::ranges::sort(numbers);
+  auto [end, _] = std::ranges::unique(numbers);
+  numbers.erase(end, numbers.end());
+  return numbers;
+}
+
+std::pair<long, long>
+Editor::contribution(const std::vector<const char *> &numbers,
+                     const std::vector<const char *> &gears) const {
+  long parts = 0, ratios = 0;
+  for (auto start : numbers) {
+    auto [x, y] = this->cells.position(start);
+    auto end = start;
+    while (is_digit(*end)) {
+      ++end;
+    }
+    if (is_part(this->cells, x, y, end - start)) {
+      parts += number_at(start);
+    }
+  }
+
+  for (auto gear : gears) {
+    if (*gear == '*') {
+      ratios += ratio(this->cells, gear);
+    }
+  }
+
+  return {parts, ratios};
+}
+
+void Editor::set(std::size_t x, std::size_t y, char c) {
+  AOC_SCOPE("03/set");
+  this->check(x, y);
+  auto &cell = this->cells.cell(x, y);
+  auto old = cell;
+  if (old == c) {
+    return;
+  }
+
+  // A number's value or whether it is a part can only change if one of its
+  // digits is within one cell of the edit; no other number can join or
+  // leave the sums. A gear's ratio can only change if it is the cell
+  // itself, or it touches such a number before or after the edit.
+  auto before = this->numbers_around(x, y);
+  cell = c;
+  auto after = this->numbers_around(x, y);
+
+  std::vector<const char *> gears = {&cell};
+  auto touching = [this, &gears](const std::vector<const char *> &numbers) {
+    for (auto start : numbers) {
+      auto [nx, ny] = this->cells.position(start);
+      auto end = start;
+      while (is_digit(*end)) {
+        ++end;
+      }
+      for (std::ptrdiff_t dy = -1; dy <= 1; ++dy) {
+        for (auto &around : this->cells.run(nx - 1, ny + dy, end - start + 2)) {
+          if (around == '*') {
+            gears.push_back(&around);
+          }
+        }
+      }
+    }
+  };
+  touching(after);
+  cell = old;
+  touching(before);
+  std::ranges::sort(gears);
+  auto [end, _] = std::ranges::unique(gears);
+  gears.erase(end, gears.end());
+
+  auto [old_parts, old_ratios] = this->contribution(before, gears);
+  cell = c;
+  auto [new_parts, new_ratios] = this->contribution(after, gears);
+  this->parts += new_parts - old_parts;
+  this->ratios += new_ratios - old_ratios;
+}
+
+std::span<const Number> Sparse::numbers_in(std::ptrdiff_t y) const {
+  if (y < 0 || static_cast<std::size_t>(y) >= this->height) {
+    return {};
+  }
+  return std::span(this->numbers)
+      .subspan(this->number_rows[y],
+               this->number_rows[y + 1] - this->number_rows[y]);
+}
+
+std::span<const Symbol> Sparse::symbols_in(std::ptrdiff_t y) const {
+  if (y < 0 || static_cast<std::size_t>(y) >= this->height) {
+    return {};
+  }
+  return std::span(this->symbols)
+      .subspan(this->symbol_rows[y],
+               this->symbol_rows[y + 1] - this->symbol_rows[y]);
+}
+
+Sparse parse_sparse(std::string_view input) {
+  AOC_SCOPE("03/parse_sparse");
+  auto rows = rows_of(input);
+  Sparse sparse;
+  sparse.width = rows.empty() ? 0 : rows.front().size();
+  sparse.height = rows.size();
+  if (sparse.width > UINT32_MAX) {
+    throw std::runtime_error("schematic rows are too long");
+  }
+
+  sparse.number_rows.push_back(0);
+  sparse.symbol_rows.push_back(0);
+  for (auto row : rows) {
+    // most of a large schematic is '.', which is skipped a run at a time
+    for (auto x = row.find_first_not_of('.'); x != std::string_view::npos;
+         x = row.find_first_not_of('.', x)) {
+      if (!is_digit(row[x])) {
+        if (is_symbol(row[x])) {
+          sparse.symbols.push_back({static_cast<std::uint32_t>(x), row[x]});
+        }
+        ++x;
+        continue;
+      }
+
+      auto end = x;
+      while (end < row.size() && is_digit(row[end])) {
+        ++end;
+      }
+      auto value = aoc::integer::parse<long>(row.substr(x, end - x));
+      if (!value) {
+        throw std::runtime_error("schematic number does not fit in a long");
+      }
+      sparse.numbers.push_back({static_cast<std::uint32_t>(x),
+                                static_cast<std::uint32_t>(end - x), *value});
+      x = end;
+    }
+
+    sparse.number_rows.push_back(sparse.numbers.size());
+    sparse.symbol_rows.push_back(sparse.symbols.size());
+  }
+
+  return sparse;
+}
+
+long part1(const Sparse &schematic) {
+  AOC_SCOPE("03/sparse1");
+  long sum = 0;
+  for (std::size_t y = 0; y < schematic.height; ++y) {
+    // numbers in a row run left to right, so each neighbouring row's symbols
+    // are walked once, by a cursor that only moves forward
+    std::array<std::span<const Symbol>, 3> nearby = {
+        schematic.symbols_in(y - 1), schematic.symbols_in(y),
+        schematic.symbols_in(y + 1)};
+    std::array<std::size_t, 3> at{};
+
+    for (const auto &number : schematic.numbers_in(y)) {
+      // the columns a symbol can sit in to touch the number
+      long first = long(number.x) - 1, last = long(number.x) + number.length;
+      bool part = false;
+      for (std::size_t r = 0; r < nearby.size(); ++r) {
+        while (at[r] < nearby[r].size() && nearby[r][at[r]].x < first) {
+          ++at[r];
+        }
+        part |= at[r] < nearby[r].size() && nearby[r][at[r]].x <= last;
+      }
+
+      if (part) {
+        sum += number.value;
+      }
+    }
+  }
+
+  return sum;
+}
+
+long part2(const Sparse &schematic) {
+  AOC_SCOPE("03/sparse2");
+  long sum = 0;
+  for (std::size_t y = 0; y < schematic.height; ++y) {
+    // as in part 1, but walking numbers around the row's gears
+    std::array<std::span<const Number>, 3> nearby = {
+        schematic.numbers_in(y - 1), schematic.numbers_in(y),
+        schematic.numbers_in(y + 1)};
+    std::array<std::size_t, 3> at{};
+
+    for (const auto &symbol : schematic.symbols_in(y)) {
+      if (symbol.c != '*') {
+        continue;
+      }
+
+      // only a gear with exactly two numbers is multiplied out, so a third
+      // is counted but not kept
+      std::array<long, 2> values{};
+      std::size_t found = 0;
+      for (std::size_t r = 0; r < nearby.size(); ++r) {
+        // skip numbers that end left of the gear's column - 1
+        while (at[r] < nearby[r].size() &&
+               nearby[r][at[r]].x + nearby[r][at[r]].length < symbol.x) {
+          ++at[r];
+        }
+        for (auto i = at[r];
+             i < nearby[r].size() && nearby[r][i].x <= symbol.x + 1; ++i) {
+          if (found < values.size()) {
+            values[found] = nearby[r][i].value;
+          }
+          ++found;
+        }
+      }
+
+      if (found == 2) {
+        sum += values[0] * values[1];
+      }
+    }
+  }
+
+  return sum;
+}
+} // namespace day03
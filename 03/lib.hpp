@@ -0,0 +1,99 @@
+#pragma once
+#include "../common/grid.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace day03 {
+// Keys cached answers; see aoc::cache::key before bumping.
+inline constexpr int version = 1;
+
+// The engine schematic, ringed by a halo of '.', so the cells around any
+// symbol or number can be read without checking for an edge.
+using Schematic = aoc::grid<char>;
+
+// Reads a schematic from its text or from a snapshot written by snap, and
+// throws if its rows differ in length.
+Schematic parse(std::string_view input);
+
+// The sum of the numbers next to a symbol, each counted once.
+long part1(const Schematic &schematic);
+// The sum of the products of the two numbers next to each '*' that has
+// exactly two.
+long part2(const Schematic &schematic);
+
+// A schematic edited a cell at a time, with both answers kept current. An
+// edit rereads only the numbers within one cell of the change, which may run
+// further along their rows, and the gears touching those numbers, so it
+// costs time in proportion to that neighbourhood rather than the schematic.
+class Editor {
+public:
+  explicit Editor(Schematic schematic);
+
+  // Throws std::out_of_range outside the schematic.
+  char get(std::size_t x, std::size_t y) const;
+  void set(std::size_t x, std::size_t y, char c);
+
+  long part1() const { return parts; }
+  long part2() const { return ratios; }
+
+  const Schematic &schematic() const { return cells; }
+
+private:
+  void check(std::size_t x, std::size_t y) const;
+  // The first digits of the numbers with a digit around (x, y).
+  std::vector<const char *> numbers_around(std::size_t x, std::size_t y) const;
+  // The sums of parts and of ratios that the numbers and gears contribute.
+  std::pair<long, long> contribution(const std::vector<const char *> &numbers,
+                                     const std::vector<const char *> &gears)
+      const;
+
+  Schematic cells;
+  long parts = 0;
+  long ratios = 0;
+};
+
+// A number in a row of a sparse schematic: its first column, digit count and
+// value.
+struct Number {
+  std::uint32_t x;
+  std::uint32_t length;
+  long value;
+};
+
+struct Symbol {
+  std::uint32_t x;
+  char c;
+};
+
+// The schematic as its numbers and symbols alone, for large schematics that
+// are mostly '.'. Each kind is stored row by row in one array, sorted by
+// column within a row, with the offset of each row's first entry alongside
+// (as in compressed sparse row matrices). Memory and solving time go with the
+// count of numbers and symbols rather than the area.
+struct Sparse {
+  std::size_t width = 0;
+  std::size_t height = 0;
+  // row y's numbers are numbers[number_rows[y], number_rows[y + 1])
+  std::vector<std::uint32_t> number_rows;
+  std::vector<Number> numbers;
+  std::vector<std::uint32_t> symbol_rows;
+  std::vector<Symbol> symbols;
+
+  // Rows outside the schematic are empty.
+  std::span<const Number> numbers_in(std::ptrdiff_t y) const;
+  std::span<const Symbol> symbols_in(std::ptrdiff_t y) const;
+};
+
+// As parse, but keeps only the numbers and symbols.
+Sparse parse_sparse(std::string_view input);
+
+// Adjacency comes from merging each row's list with those of the rows above
+// and below, so these make one pass over the numbers and symbols.
+long part1(const Sparse &schematic);
+long part2(const Sparse &schematic);
+} // namespace day03
@@ -0,0 +1,148 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "lib.hpp"
+#include "../common/grid.hpp"
+#include "../common/snapshot.hpp"
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace day03;
+
+constexpr auto example = R"EOF(
+467..114..
+...*......
+..35..633.
+......#...
+617*......
+.....+.58.
+..592.....
+......755.
+...$.*....
+.664.598..
+)EOF";
+
+TEST_CASE("03-parts") {
+  auto schematic = parse(1 + example);
+  CHECK(schematic.width() == 10);
+  CHECK(schematic.height() == 10);
+  CHECK(part1(schematic) == 4361);
+  CHECK(part2(schematic) == 467835);
+
+  auto snapshot = aoc::snapshot::write_grid("03", 1 + example);
+  auto mapped = parse(snapshot);
+  CHECK(part1(mapped) == 4361);
+  CHECK(part2(mapped) == 467835);
+
+  CHECK_THROWS(parse("12.\n.*\n"));
+}
+
+TEST_CASE("03-edges") {
+  // symbols and numbers on every edge and corner read into the halo
+  auto corners = parse("*2.3*\n1...4\n*5.6*\n");
+  CHECK(part1(corners) == 2 + 3 + 1 + 4 + 5 + 6);
+  CHECK(part2(corners) == 2 * 1 + 3 * 4 + 1 * 5 + 4 * 6);
+
+  // a number next to two symbols is still one part
+  CHECK(part1(parse("#12#\n")) == 12);
+  CHECK(part2(parse("12*34\n")) == 408);
+  CHECK(part2(parse("12*\n.34\n")) == 408);
+  CHECK(part2(parse("1*2*3\n")) == 2 + 6);
+  CHECK(part1(parse("")) == 0);
+}
+
+TEST_CASE("03-sparse") {
+  auto sparse = parse_sparse(1 + example);
+  CHECK(sparse.width == 10);
+  CHECK(sparse.numbers.size() == 10);
+  CHECK(sparse.symbols.size() == 6);
+  REQUIRE(sparse.numbers_in(0).size() == 2);
+  CHECK(sparse.numbers_in(0)[1].x == 5);
+  CHECK(sparse.numbers_in(0)[1].length == 3);
+  CHECK(sparse.numbers_in(0)[1].value == 114);
+  CHECK(sparse.symbols_in(8)[1].c == '*');
+  CHECK(sparse.numbers_in(-1).empty());
+  CHECK(sparse.symbols_in(10).empty());
+  CHECK(part1(sparse) == 4361);
+  CHECK(part2(sparse) == 467835);
+
+  // the merge agrees with the dense solvers around edges, runs of symbols
+  // and gears with too many numbers
+  for (auto text : {"*2.3*\n1...4\n*5.6*\n", "#12#\n", "12*34\n",
+                    "12*\n.34\n", "1*2*3\n", "1.1\n.*.\n1.1\n",
+                    "123...\n...*..\n....45\n", "..\n..\n", ""}) {
+    CHECK(part1(parse_sparse(text)) == part1(parse(text)));
+    CHECK(part2(parse_sparse(text)) == part2(parse(text)));
+  }
+
+  // three numbers whose product overflows a long aren't a gear either
+  CHECK(part2(parse_sparse("9999999999*9999999999\n"
+                           "..........9999999999.\n")) == 0);
+
+  CHECK_THROWS(parse_sparse("12.\n.*\n"));
+  CHECK_THROWS(parse_sparse("99999999999999999999\n"));
+}
+
+TEST_CASE("03-editor") {
+  Editor editor(parse(1 + example));
+  CHECK(editor.part1() == 4361);
+  CHECK(editor.part2() == 467835);
+
+  // each edit leaves the sums as solving the edited schematic would
+  auto same = [&editor] {
+    return editor.part1() == part1(editor.schematic()) &&
+           editor.part2() == part2(editor.schematic());
+  };
+
+  editor.set(3, 6, '*'); // 592 splits around a gear of its own
+  CHECK(editor.part1() == 4361 - 592 + 5 + 2);
+  CHECK(editor.part2() == 467835 + 5 * 2);
+  CHECK(same());
+  editor.set(3, 6, '9'); // and back
+  CHECK(editor.part1() == 4361);
+  CHECK(editor.part2() == 467835);
+
+  editor.set(3, 1, '.'); // 467 and 35 lose their gear
+  CHECK(editor.part1() == 4361 - 467 - 35);
+  CHECK(editor.part2() == 467835 - 467 * 35);
+  CHECK(same());
+
+  editor.set(3, 0, '8'); // 467 grows to 4678
+  editor.set(4, 0, '1'); // and joins 114 as 46781114
+  CHECK(editor.get(4, 0) == '1');
+  CHECK(same());
+  editor.set(9, 9, '#'); // on the corner, touching nothing
+  CHECK(same());
+  editor.set(6, 1, '*'); // a gear under 46781114 and over 633
+  CHECK(editor.part2() == 467835 - 467 * 35 + 46781114L * 633);
+  CHECK(same());
+
+  CHECK_THROWS_AS(editor.set(10, 0, '.'), std::out_of_range);
+  CHECK_THROWS_AS(editor.get(0, 10), std::out_of_range);
+}
+
+TEST_CASE("03-grid") {
+  aoc::grid<std::uint32_t> grid(3, 2, 7);
+  CHECK(grid.stride() % (aoc::grid<std::uint32_t>::alignment / 4) == 0);
+  for (std::ptrdiff_t y = -1; y <= 2; ++y) {
+    CHECK(reinterpret_cast<std::uintptr_t>(grid.row(y).data()) % 64 == 0);
+    for (std::ptrdiff_t x = -1; x <= 3; ++x) {
+      CHECK(grid.cell(x, y) == 7);
+    }
+  }
+
+  grid.cell(0, 0) = 1;
+  grid.cell(2, 1) = 2;
+  CHECK(grid.row(1)[2] == 2);
+  CHECK(grid.run(-1, 0, 5)[1] == 1);
+  auto [x, y] = grid.position(grid.data(2, 1));
+  CHECK(x == 2);
+  CHECK(y == 1);
+
+  // the eight neighbours of (1, 0), row by row from the top left
+  std::vector<std::uint32_t> around;
+  for (auto offset : grid.neighbours()) {
+    around.push_back(grid.data(1, 0)[offset]);
+  }
+  CHECK(around == std::vector<std::uint32_t>{7, 7, 7, 1, 7, 7, 7, 2});
+}
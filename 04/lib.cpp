@@ -1,35 +1,58 @@
+#include "lib.hpp"
+#include "../common/instrument.hpp"
+#include "../common/integer.hpp"
+#include "../common/snapshot.hpp"
+#include "../common/structural.hpp"
+
 #include <algorithm>
+#include <bitset>
+#include <climits>
 #include <cmath>
+#include <cstdint>
+#include <format>
 #include <fstream>
+#include <iterator>
 #include <lexy/action/parse.hpp>
 #include <lexy/callback/container.hpp>
+#include <lexy/callback/fold.hpp>
 #include <lexy/dsl.hpp>
 #include <lexy/input/string_input.hpp>
 #include <lexy_ext/report_error.hpp>
+#include <memory_resource>
 #include <numeric>
+#include <optional>
 #include <ranges>
-#include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+namespace day04 {
 namespace {
-struct Card {
-  int id;
-  std::set<int> winning;
-  std::vector<int> picks;
-};
-
 namespace grammar {
 namespace dsl = lexy::dsl;
 
+// a number too big for the card's bitset is an overflow error
+constexpr auto number =
+    dsl::integer<lexy::bounded<int, number_limit - 1>>(dsl::digits<>);
+
 struct winning {
-  static constexpr auto rule = dsl::list(dsl::integer<int>(dsl::digits<>));
-  static constexpr auto value = lexy::as_collection<std::set<int>>;
+  static constexpr auto rule = dsl::list(number);
+  static constexpr auto value =
+      lexy::fold_inplace<std::bitset<number_limit>>(
+          std::bitset<number_limit>{},
+          [](std::bitset<number_limit> &set, int n) { set.set(n); });
 };
 
 struct picks {
-  static constexpr auto rule = dsl::list(dsl::integer<int>(dsl::digits<>));
-  static constexpr auto value = lexy::as_list<std::vector<int>>;
+  static constexpr auto rule = dsl::list(number);
+  static constexpr auto value =
+      lexy::fold_inplace<Picks>(Picks{}, [](Picks &picks, int n) {
+        if (!picks.push_back(n)) {
+          throw std::runtime_error("too many picks on a card");
+        }
+      });
 };
 
 struct production {
@@ -41,90 +64,318 @@ struct production {
   static constexpr auto value = lexy::construct<Card>;
 };
 
+// Every card in one parse over the whole input. Newlines are whitespace, so
+// cards follow one another and go straight into the list sink; errors are
+// reported against their line in the file.
+struct cards {
+  static constexpr auto rule =
+      dsl::terminator(dsl::eof).opt_list(dsl::p<production>);
+
+  static constexpr auto whitespace = dsl::ascii::space;
+  static constexpr auto value = lexy::as_list<Cards>.allocator();
+};
+
 } // namespace grammar
-} // namespace
 
-int part1(std::istream &input) {
-  std::string line;
+int matches(const Card &card) {
+  return std::ranges::count_if(
+      card.picks, [&card](int i) { return card.winning.test(i); });
+}
+
+// Only the next rowsize cards can be affected by the current one, so the
+// counts are kept in a ring buffer the width of a card. Cards must be added
+// in order.
+class cascade {
+public:
+  void add(const Card &card) { this->add(matches(card), card.picks.size()); }
+
+  // A card with count matches, in a table where no card has more than width.
+  void add(int count, std::size_t width) {
+    if (this->rowsize == 0) {
+      this->rowsize = width;
+      this->counts.resize(this->rowsize, 1);
+    }
+
+    for (int j = 1; j <= count; ++j) {
+      this->counts[(this->i + j) % this->rowsize] += this->counts[this->i];
+    }
+
+    this->sum += this->counts[this->i];
+    this->counts[this->i] = 1;
+    this->i = (this->i + 1) % this->rowsize;
+  }
+
+  int total() const { return this->sum; }
+
+private:
+  std::vector<int> counts;
+  int rowsize = 0;
   int sum = 0;
-  while (std::getline(input, line)) {
-    auto str = lexy::string_input(line);
-    auto result = lexy::parse<grammar::production>(str, lexy_ext::report_error);
+  int i = 0;
+};
 
-    if (result.has_value()) {
-      Card card = result.value();
+constexpr auto matches_tag = aoc::snapshot::tag("mtch");
 
-      int count = std::ranges::count_if(
-          card.picks, [&card](int i) { return card.winning.contains(i); });
+// A card from one line of a pipeline, or nothing for a blank line. A line
+// that isn't a card throws, as parse does, and the pipeline passes the error
+// on to its caller.
+std::optional<Card> parse_card(std::string_view line, aoc::arena &arena) {
+  if (line.empty()) {
+    return std::nullopt;
+  }
 
-      if (count > 0) {
-        sum += pow(2, count - 1);
+  auto str = lexy::string_input(line);
+  auto result = lexy::parse<grammar::production>(str, arena.allocator(),
+                                                 lexy_ext::report_error);
+  if (!result.has_value()) {
+    throw std::runtime_error(std::format("failed to parse card: {}", line));
+  }
+
+  return std::move(result).value();
+}
+
+// Reads cards straight off the structural index: ':' closes the header and
+// '|' splits the winning numbers from the picks, and each side is converted
+// in one batch. Anything that doesn't fit gives up, leaving the grammar to
+// report the error.
+std::optional<Cards> parse_indexed(std::string_view input, aoc::arena &arena) {
+  aoc::structural_index index(input);
+  Cards cards(arena.allocator());
+  cards.reserve(index.line_count());
+  for (std::size_t i = 0; i < index.line_count(); ++i) {
+    auto line = index.line(i);
+    if (line.empty()) {
+      continue;
+    }
+
+    std::size_t start = line.data() - input.data();
+    std::size_t colon = 0, bar = 0;
+    for (auto at : index.structurals(i)) {
+      if (input[at] == ':' && colon == 0) {
+        colon = at - start;
+      } else if (input[at] == '|' && colon != 0 && bar == 0) {
+        bar = at - start;
+      } else if (input[at] != ' ') {
+        return std::nullopt;
       }
     }
+
+    // the grammar only takes unsigned numbers
+    auto header = line.substr(0, colon);
+    if (bar == 0 || !header.starts_with("Card ") ||
+        line.find('-') != std::string_view::npos) {
+      return std::nullopt;
+    }
+
+    auto digits = header.find_first_not_of(' ', 4);
+    auto id = digits == std::string_view::npos
+                  ? std::nullopt
+                  : aoc::integer::parse<int>(header.substr(digits));
+    if (!id) {
+      return std::nullopt;
+    }
+
+    Card card{*id, {}, {}};
+    bool fits = true;
+    auto mark = [&](int n) {
+      fits = fits && n < number_limit;
+      if (fits) {
+        card.winning.set(n);
+      }
+    };
+    auto pick = [&](int n) {
+      fits = fits && n < number_limit && card.picks.push_back(n);
+    };
+
+    bool numbers = aoc::integer::parse_each<int>(
+                       line.substr(colon + 1, bar - colon - 1), mark) &&
+                   aoc::integer::parse_each<int>(line.substr(bar + 1), pick);
+    if (!numbers || !fits || card.winning.none() || card.picks.empty()) {
+      return std::nullopt;
+    }
+
+    cards.push_back(std::move(card));
   }
 
-  return sum;
+  return cards;
 }
 
-int part2(std::istream &input) {
-  std::string line;
-  std::vector<Card> cards;
-  while (std::getline(input, line)) {
-    auto str = lexy::string_input(line);
-    auto result = lexy::parse<grammar::production>(str, lexy_ext::report_error);
+std::string slurp(std::istream &input) {
+  auto it = std::istreambuf_iterator(input);
+  return std::string(it, {});
+}
+} // namespace
 
-    if (result.has_value()) {
-      Card card = result.value();
-      cards.push_back(card);
-    }
+Cards parse(std::string_view input, aoc::arena &arena) {
+  AOC_SCOPE("04/parse");
+  if (auto cards = parse_indexed(input, arena)) {
+    return std::move(*cards);
   }
 
-  std::vector<int> counts(cards.size(), 1);
-  for (int i = 0; auto card : cards) {
-    int count = std::ranges::count_if(
-        card.picks, [&card](int i) { return card.winning.contains(i); });
+  // anything unusual goes through the grammar, which reports the error
+  auto result = lexy::parse<grammar::cards>(
+      lexy::string_input(input), arena.allocator(), lexy_ext::report_error);
+  // a card the list recovered from has still been dropped
+  if (!result.is_success()) {
+    throw std::runtime_error("failed to parse");
+  }
 
-    for (int j = 1; j <= count; ++j) {
-      counts[i + j] += counts[i];
+  return std::move(result).value();
+}
+
+int part1(const Cards &cards) {
+  AOC_SCOPE("04/part1");
+  int sum = 0;
+  for (const auto &card : cards) {
+    if (int count = matches(card); count > 0) {
+      sum += pow(2, count - 1);
     }
+  }
+
+  return sum;
+}
 
-    ++i;
+int part2(const Cards &cards) {
+  AOC_SCOPE("04/part2");
+  std::vector<int> counts(cards.size(), 1);
+  for (std::size_t i = 0; i < counts.size(); ++i) {
+    // copies past the end of the table don't exist
+    auto last =
+        std::min<std::size_t>(i + matches(cards[i]), counts.size() - 1);
+    for (auto j = i + 1; j <= last; ++j) {
+      counts[j] += counts[i];
+    }
   }
 
   return std::reduce(counts.begin(), counts.end());
 }
 
-int part2_cooler(std::istream &input) {
-  std::string line;
-  std::vector<int> counts;
-  int rowsize = 0;
+int part2_cooler(const Cards &cards) {
+  AOC_SCOPE("04/part2_cooler");
+  cascade copies;
+  for (const auto &card : cards) {
+    copies.add(card);
+  }
 
-  int sum = 0;
-  int i = 0;
-  while (std::getline(input, line)) {
-    auto str = lexy::string_input(line);
-    auto result = lexy::parse<grammar::production>(str, lexy_ext::report_error);
+  return copies.total();
+}
 
-    if (result.has_value()) {
-      Card card = result.value();
+std::string snapshot(const Cards &cards) {
+  std::vector<std::uint8_t> counts;
+  counts.reserve(cards.size());
+  for (const auto &card : cards) {
+    int count = matches(card);
+    if (count > UINT8_MAX) {
+      throw std::runtime_error("too many matches for a snapshot");
+    }
+    counts.push_back(count);
+  }
 
-      if (rowsize == 0) {
-        rowsize = card.picks.size();
-        counts.resize(rowsize, 1);
-      }
+  aoc::snapshot::writer out("04", version);
+  out.add(matches_tag, counts);
+  return out.finish();
+}
 
-      int count = std::ranges::count_if(
-          card.picks, [&card](int i) { return card.winning.contains(i); });
+Matches load(std::string_view snapshot) {
+  aoc::snapshot::reader in(snapshot, "04", version);
+  return {in.get<std::uint8_t>(matches_tag)};
+}
 
-      for (int j = 1; j <= count; ++j) {
-        counts[(i + j) % rowsize] += counts[i];
-      }
+int part1(const Matches &matches) {
+  AOC_SCOPE("04/part1");
+  int sum = 0;
+  for (int count : matches.counts) {
+    if (count > 0) {
+      sum += pow(2, count - 1);
+    }
+  }
+
+  return sum;
+}
 
-      sum += counts[i];
-      counts[i] = 1;
-      i = (i + 1) % rowsize;
+int part2(const Matches &matches) {
+  AOC_SCOPE("04/part2");
+  std::vector<int> counts(matches.counts.size(), 1);
+  for (std::size_t i = 0; i < counts.size(); ++i) {
+    // copies past the end of the table don't exist
+    auto last = std::min<std::size_t>(i + matches.counts[i], counts.size() - 1);
+    for (auto j = i + 1; j <= last; ++j) {
+      counts[j] += counts[i];
     }
   }
 
+  return std::reduce(counts.begin(), counts.end());
+}
+
+int part2_cooler(const Matches &matches) {
+  AOC_SCOPE("04/part2_cooler");
+  if (matches.counts.empty()) {
+    return 0;
+  }
+
+  std::size_t width = *std::ranges::max_element(matches.counts) + 1;
+  cascade copies;
+  for (int count : matches.counts) {
+    copies.add(count, width);
+  }
+
+  return copies.total();
+}
+
+int part1(std::istream &input) { return part1(std::string_view(slurp(input))); }
+int part1(std::string_view input) {
+  aoc::arena arena;
+  return part1(parse(input, arena));
+}
+
+int part2(std::istream &input) { return part2(std::string_view(slurp(input))); }
+int part2(std::string_view input) {
+  aoc::arena arena;
+  return part2(parse(input, arena));
+}
+
+int part2_cooler(std::istream &input) {
+  return part2_cooler(std::string_view(slurp(input)));
+}
+int part2_cooler(std::string_view input) {
+  aoc::arena arena;
+  return part2_cooler(parse(input, arena));
+}
+
+int part1(std::istream &input, const aoc::pipeline_options &options) {
+  AOC_SCOPE("04/part1");
+  auto unordered = options;
+  unordered.ordered = false;
+
+  int sum = 0;
+  aoc::pipeline(
+      input, parse_card,
+      [&](const std::optional<Card> &card) {
+        if (int count = card ? matches(*card) : 0; count > 0) {
+          sum += pow(2, count - 1);
+        }
+      },
+      unordered);
+
   return sum;
-}
\ No newline at end of file
+}
+
+// Copies cascade down the table, so cards are solved in order.
+int part2_cooler(std::istream &input, const aoc::pipeline_options &options) {
+  AOC_SCOPE("04/part2_cooler");
+  auto ordered = options;
+  ordered.ordered = true;
+
+  cascade copies;
+  aoc::pipeline(
+      input, parse_card,
+      [&](const std::optional<Card> &card) {
+        if (card) {
+          copies.add(*card);
+        }
+      },
+      ordered);
+
+  return copies.total();
+}
+} // namespace day04
@@ -1,6 +1,89 @@
 #pragma once
+#include "../common/arena.hpp"
+#include "../common/pipeline.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
 #include <istream>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace day04 {
+// Keys cached answers and snapshots; see aoc::cache::key before bumping.
+inline constexpr int version = 1;
+
+// Every number on a card is below this.
+inline constexpr int number_limit = 100;
+
+// A card's picks in order, stored inline. Real cards have 25.
+struct Picks {
+  static constexpr std::size_t capacity = 32;
+
+  std::array<std::uint8_t, capacity> numbers{};
+  std::uint8_t count = 0;
+
+  // Adds nothing and returns false once the card is full.
+  constexpr bool push_back(int n) {
+    if (count == capacity) {
+      return false;
+    }
+    numbers[count++] = static_cast<std::uint8_t>(n);
+    return true;
+  }
+
+  constexpr std::size_t size() const { return count; }
+  constexpr bool empty() const { return count == 0; }
+  constexpr const std::uint8_t *begin() const { return numbers.data(); }
+  constexpr const std::uint8_t *end() const { return numbers.data() + count; }
+};
 
+struct Card {
+  int id;
+  std::bitset<number_limit> winning;
+  Picks picks;
+};
+
+// Every card in the input, in order. The model is immutable once parsed, so
+// the solvers below can share one across threads.
+using Cards = std::pmr::vector<Card>;
+
+// Parses the whole input into the arena, which must outlive the cards, and
+// throws if any card is malformed.
+Cards parse(std::string_view input, aoc::arena &arena);
+
+int part1(const Cards &cards);
 int part1(std::istream &input);
+int part1(std::string_view input);
+int part2(const Cards &cards);
 int part2(std::istream &input);
+int part2(std::string_view input);
+int part2_cooler(const Cards &cards);
 int part2_cooler(std::istream &input);
+int part2_cooler(std::string_view input);
+
+// Cards as a snapshot keeps them: only each card's number of matches, which
+// is all the solvers read. The counts point into the snapshot's bytes.
+struct Matches {
+  std::span<const std::uint8_t> counts;
+};
+
+// Writes the cards as a snapshot (see common/snapshot.hpp), and reads one
+// back in place, throwing if it isn't a snapshot of this version of day 04.
+std::string snapshot(const Cards &cards);
+Matches load(std::string_view snapshot);
+
+int part1(const Matches &matches);
+int part2(const Matches &matches);
+int part2_cooler(const Matches &matches);
+
+// Stream the input through aoc::pipeline, parsing lines on worker threads.
+// Part 1 sums cards as they arrive; part 2 needs them in order. Memory stays
+// bounded by options.depth batches however long the input is.
+int part1(std::istream &input, const aoc::pipeline_options &options);
+int part2_cooler(std::istream &input, const aoc::pipeline_options &options);
+} // namespace day04
@@ -1,19 +1,33 @@
+#include "../common/cache.hpp"
+#include "../common/input.hpp"
 #include "lib.hpp"
 
-#include <fstream>
 #include <iostream>
+#include <optional>
 
 int main() {
-  std::ifstream input_file("input");
+  aoc::mapped_file input_file("input");
 
   if (input_file.is_open()) {
-    std::cout << "part1: " << part1(input_file) << std::endl;
-    input_file.clear();
-    input_file.seekg(0, std::iostream::beg);
-    std::cout << "part2: " << part2(input_file) << std::endl;
-    input_file.clear();
-    input_file.seekg(0, std::iostream::beg);
-    std::cout << "part2-cooler: " << part2_cooler(input_file) << std::endl;
-    input_file.close();
+    aoc::cache::answers answers("04", day04::version, input_file.view());
+    aoc::arena arena;
+    std::optional<day04::Cards> cards;
+    auto model = [&]() -> const day04::Cards & {
+      if (!cards) {
+        cards.emplace(day04::parse(input_file.view(), arena));
+      }
+      return *cards;
+    };
+
+    std::cout << "part1: "
+              << answers.get("1", [&] { return day04::part1(model()); })
+              << std::endl;
+    std::cout << "part2: "
+              << answers.get("2", [&] { return day04::part2(model()); })
+              << std::endl;
+    std::cout << "part2-cooler: "
+              << answers.get("2-cooler",
+                             [&] { return day04::part2_cooler(model()); })
+              << std::endl;
   }
-}
\ No newline at end of file
+}
@@ -1,7 +1,10 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "lib.hpp"
+#include "../common/alloc.hpp"
 #include <doctest/doctest.h>
 
+using namespace day04;
+
 TEST_CASE("part1") {
   constexpr auto example = R"EOF(
 Card 1: 41 48 83 86 17 | 83 86  6 31 17  9 48 53
@@ -14,6 +17,7 @@ Card 6: 31 18 13 56 72 | 74 77 10 23 35 67 36 11
 
   std::stringstream ss(1 + example);
   CHECK(part1(ss) == 13);
+  CHECK(part1(std::string_view(1 + example)) == 13);
 }
 
 TEST_CASE("part2") {
@@ -41,3 +45,114 @@ Card 6: 31 18 13 56 72 | 74 77 10 23 35 67 36 11
   std::stringstream ss(1 + example);
   CHECK(part2(ss) == 30);
 }
+
+TEST_CASE("parse") {
+  constexpr auto example = R"EOF(
+Card 1: 41 48 83 86 17 | 83 86  6 31 17  9 48 53
+Card 2: 13 32 20 16 61 | 61 30 68 82 17 32 24 19
+Card 3:  1 21 53 59 44 | 69 82 63 72 16 21 14  1
+Card 4: 41 92 73 84 69 | 59 84 76 51 58  5 54 83
+Card 5: 87 83 26 28 32 | 88 30 70 12 93 22 82 36
+Card 6: 31 18 13 56 72 | 74 77 10 23 35 67 36 11
+)EOF";
+  aoc::arena arena;
+  auto cards = parse(1 + example, arena);
+  REQUIRE(cards.size() == 6);
+  CHECK(cards[2].id == 3);
+  CHECK(cards[2].winning.count() == 5);
+  CHECK(cards[2].picks.size() == 8);
+
+  CHECK(part1(cards) == 13);
+  CHECK(part2(cards) == 30);
+  CHECK(part2_cooler(cards) == 30);
+
+  // the second card is missing its separator
+  CHECK_THROWS(parse("Card 1: 41 48 | 83 86\nCard 2: 13 32 61 30\n", arena));
+  // the last card's matches would copy cards past the end of the table
+  auto last = parse("Card 1: 1 2 | 1\nCard 2: 1 2 | 1 2\n", arena);
+  CHECK(part2(last) == 3);
+
+  // numbers have to fit the card's bitset
+  CHECK_THROWS(parse("Card 1: 41 100 | 83 86\n", arena));
+}
+
+TEST_CASE("parse-fallback") {
+  // no space before the id misses the indexed fast path, but the grammar
+  // still takes it
+  aoc::arena arena;
+  auto cards = parse("Card  1: 41 48 | 83 48\nCard2:\t1 | 1\n", arena);
+  REQUIRE(cards.size() == 2);
+  CHECK(cards[0].winning.count() == 2);
+  CHECK(part1(cards) == 2);
+}
+
+TEST_CASE("pipeline") {
+  constexpr auto example = R"EOF(
+Card 1: 41 48 83 86 17 | 83 86  6 31 17  9 48 53
+Card 2: 13 32 20 16 61 | 61 30 68 82 17 32 24 19
+Card 3:  1 21 53 59 44 | 69 82 63 72 16 21 14  1
+Card 4: 41 92 73 84 69 | 59 84 76 51 58  5 54 83
+Card 5: 87 83 26 28 32 | 88 30 70 12 93 22 82 36
+Card 6: 31 18 13 56 72 | 74 77 10 23 35 67 36 11
+)EOF";
+  // tiny blocks split the input across batches and workers
+  aoc::pipeline_options options{.block_size = 16, .depth = 2, .workers = 3};
+
+  std::stringstream p1(1 + example);
+  CHECK(part1(p1, options) == 13);
+  std::stringstream p2(1 + example);
+  CHECK(part2_cooler(p2, options) == 30);
+
+  // a bad card fails the run rather than dropping out of the totals
+  std::stringstream bad1("Card 1: 41 48 | 83 86\nCard 2: 13 32 61 30\n");
+  CHECK_THROWS(part1(bad1, options));
+  std::stringstream bad2("Card 1: 41 48 | 83 86\nCard 2: 13 32 61 30\n");
+  CHECK_THROWS(part2_cooler(bad2, options));
+}
+
+TEST_CASE("snapshot") {
+  constexpr auto example = R"EOF(
+Card 1: 41 48 83 86 17 | 83 86  6 31 17  9 48 53
+Card 2: 13 32 20 16 61 | 61 30 68 82 17 32 24 19
+Card 3:  1 21 53 59 44 | 69 82 63 72 16 21 14  1
+Card 4: 41 92 73 84 69 | 59 84 76 51 58  5 54 83
+Card 5: 87 83 26 28 32 | 88 30 70 12 93 22 82 36
+Card 6: 31 18 13 56 72 | 74 77 10 23 35 67 36 11
+)EOF";
+  aoc::arena arena;
+  auto bytes = snapshot(parse(1 + example, arena));
+  auto matches = load(bytes);
+  CHECK(std::vector(matches.counts.begin(), matches.counts.end()) ==
+        std::vector<std::uint8_t>{4, 2, 2, 1, 0, 0});
+  CHECK(part1(matches) == 13);
+  CHECK(part2(matches) == 30);
+  CHECK(part2_cooler(matches) == 30);
+  CHECK_THROWS(load(1 + example));
+}
+
+#ifdef AOC_TRACK_ALLOC
+// The structural index's offsets and line breaks, and part 2's cascade; the
+// cards themselves stay in the arena's inline buffer.
+TEST_CASE("allocations") {
+  constexpr auto example = R"EOF(
+Card 1: 41 48 83 86 17 | 83 86  6 31 17  9 48 53
+Card 2: 13 32 20 16 61 | 61 30 68 82 17 32 24 19
+Card 3:  1 21 53 59 44 | 69 82 63 72 16 21 14  1
+Card 4: 41 92 73 84 69 | 59 84 76 51 58  5 54 83
+Card 5: 87 83 26 28 32 | 88 30 70 12 93 22 82 36
+Card 6: 31 18 13 56 72 | 74 77 10 23 35 67 36 11
+)EOF";
+  REQUIRE(aoc::alloc::tracking());
+  auto input = std::string_view(1 + example);
+
+  auto [part1_answer, part1_used] =
+      aoc::alloc::measure([&] { return part1(input); });
+  CHECK(part1_answer == 13);
+  CHECK(aoc::alloc::within(part1_used, {.count = 12, .peak = 2048}));
+
+  auto [part2_answer, part2_used] =
+      aoc::alloc::measure([&] { return part2_cooler(input); });
+  CHECK(part2_answer == 30);
+  CHECK(aoc::alloc::within(part2_used, {.count = 14, .peak = 2048}));
+}
+#endif
@@ -1,4 +1,10 @@
+#include "lib.hpp"
+#include "../common/instrument.hpp"
+#include "../common/snapshot.hpp"
+
 #include <algorithm>
+#include <cstdint>
+#include <format>
 #include <iostream>
 #include <istream>
 #include <iterator>
@@ -9,45 +15,24 @@
 #include <lexy/input/buffer.hpp>
 #include <lexy/input/string_input.hpp>
 #include <lexy_ext/report_error.hpp>
-#include <map>
+#include <memory_resource>
 #include <ranges>
 #include <set>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+namespace day05 {
 namespace {
-struct MapEntry {
-  long destStart;
-  long sourceStart;
-  long length;
-};
-
-struct Mapping {
-  std::string source;
-  std::string dest;
-  std::vector<MapEntry> entries;
-};
-
-template <bool P2> struct Almanac;
-
-template <> struct Almanac<true> {
-  std::string input;
-  std::vector<std::pair<long, long>> inputs;
-  std::vector<Mapping> mappings;
-};
-
-template <> struct Almanac<false> {
-  std::string input;
-  std::vector<long> inputs;
-  std::vector<Mapping> mappings;
-};
-
 namespace grammar {
 namespace dsl = lexy::dsl;
 
 struct identifier {
   static constexpr auto rule = dsl::identifier(dsl::ascii::alpha);
-  static constexpr auto value = lexy::as_string<std::string>;
+  static constexpr auto value = lexy::as_string<std::pmr::string>.allocator();
 };
 
 struct mapEntry {
@@ -60,7 +45,8 @@ struct mapEntry {
 struct mapBody {
   static constexpr auto rule = dsl::list(dsl::p<mapEntry>);
 
-  static constexpr auto value = lexy::as_list<std::vector<MapEntry>>;
+  static constexpr auto value =
+      lexy::as_list<std::pmr::vector<MapEntry>>.allocator();
 };
 
 struct mapping {
@@ -78,205 +64,208 @@ struct mappings {
   static constexpr auto rule =
       dsl::list(dsl::p<mapping>, dsl::sep(dsl::newline));
 
-  static constexpr auto value = lexy::as_list<std::vector<Mapping>>;
-};
-
-struct range {
-  static constexpr auto rule =
-      dsl::peek(dsl::digit<>) >> dsl::integer<long> + dsl::integer<long>;
-  static constexpr auto value = lexy::construct<std::pair<long, long>>;
-};
-
-template <bool P2> struct inputs;
-
-template <> struct inputs<true> {
-  static constexpr auto rule =
-      dsl::list(dsl::p<range>) + dsl::newline + dsl::newline;
   static constexpr auto value =
-      lexy::as_list<std::vector<std::pair<long, long>>>;
+      lexy::as_list<std::pmr::vector<Mapping>>.allocator();
 };
 
-template <> struct inputs<false> {
+struct inputs {
   static constexpr auto rule =
       dsl::list(dsl::integer<long>) + dsl::newline + dsl::newline;
-  static constexpr auto value = lexy::as_list<std::vector<long>>;
+  static constexpr auto value =
+      lexy::as_list<std::pmr::vector<long>>.allocator();
 };
 
-template <bool P2> struct production {
+struct production {
   static constexpr auto rule =
-      dsl::p<identifier> + dsl::colon + dsl::p<inputs<P2>> + dsl::p<mappings>;
+      dsl::p<identifier> + dsl::colon + dsl::p<inputs> + dsl::p<mappings>;
 
   static constexpr auto whitespace = dsl::ascii::blank;
-  static constexpr auto value = lexy::construct<Almanac<P2>>;
+  static constexpr auto value = lexy::construct<Almanac>;
 };
 } // namespace grammar
-} // namespace
 
-int part1(std::istream &input) {
+std::string slurp(std::istream &input) {
   auto it = std::istreambuf_iterator(input);
-  std::string in(it, {});
-  auto res = lexy::parse<grammar::production<false>>(lexy::string_input(in),
-                                                     lexy_ext::report_error);
+  return std::string(it, {});
+}
+} // namespace
+
+Almanac parse(std::string_view input, aoc::arena &arena) {
+  AOC_SCOPE("05/parse");
+  auto res = lexy::parse<grammar::production>(
+      lexy::string_input(input), arena.allocator(), lexy_ext::report_error);
   if (!res.has_value()) {
     throw std::runtime_error("failed to parse");
   }
 
-  auto almanac = res.value();
-  std::map<std::string, std::string> categoryPath;
-  std::map<std::string, std::map<long, MapEntry>> sourceIndexes;
-  for (auto map : almanac.mappings) {
-    categoryPath.emplace(map.source, map.dest);
+  return std::move(res).value();
+}
+
+namespace {
+constexpr auto seeds_tag = aoc::snapshot::tag("seed");
+constexpr auto bounds_tag = aoc::snapshot::tag("stag");
+constexpr auto entries_tag = aoc::snapshot::tag("maps");
+
+// The almanac laid out as Stages: its maps followed from the seeds' category
+// to location, each sorted by source. Both the snapshot and the Almanac
+// solvers start from this, so there is only one set of solvers.
+struct staged {
+  std::vector<long> seeds;
+  std::vector<std::uint32_t> bounds = {0};
+  std::vector<MapEntry> entries;
 
-    std::map<long, MapEntry> sourceIndex;
-    for (auto entry : map.entries) {
-      sourceIndex.emplace(entry.sourceStart, entry);
-    }
+  Stages view() const { return {seeds, bounds, entries}; }
+};
 
-    sourceIndexes.emplace(map.source, sourceIndex);
+staged stage(const Almanac &almanac) {
+  std::string_view category = almanac.input;
+  if (category == "seeds") {
+    category = "seed";
   }
 
-  auto startCategory = almanac.input == "seeds" ? "seed" : almanac.input;
-  constexpr auto targetCategory = "location";
-  auto category = startCategory;
+  staged out{{almanac.seeds.begin(), almanac.seeds.end()}};
+  std::set<std::string_view> seen;
+  while (category != "location") {
+    auto map = std::ranges::find(almanac.mappings, category, &Mapping::source);
+    if (map == almanac.mappings.end()) {
+      throw std::runtime_error(std::format("no map from {}", category));
+    }
+    if (!seen.insert(category).second) {
+      throw std::runtime_error(std::format("category {} traversed already",
+                                           category));
+    }
+
+    auto first = out.entries.size();
+    out.entries.insert(out.entries.end(), map->entries.begin(),
+                       map->entries.end());
+    std::ranges::sort(out.entries.begin() + first, out.entries.end(), {},
+                      &MapEntry::sourceStart);
+    out.bounds.push_back(out.entries.size());
+    category = map->dest;
+  }
 
-  std::set<std::string> seenCategories;
-  auto inputs = almanac.inputs;
+  return out;
+}
+} // namespace
 
-  while (category != targetCategory) {
-    if (seenCategories.contains(category)) {
-      throw std::runtime_error("category " + category + " traversed already");
-    }
+int part1(const Almanac &almanac) { return part1(stage(almanac).view()); }
 
-    auto sourceIndex = sourceIndexes[category];
-    for (int i = 0; auto input : inputs) {
-      long output = input;
+int part2(const Almanac &almanac) { return part2(stage(almanac).view()); }
 
-      auto possibleRange = sourceIndex.lower_bound(input);
-      if (possibleRange->first == input ||
-          possibleRange != sourceIndex.begin()) {
-        if (possibleRange->first != input) {
-          --possibleRange;
-        }
-        auto entry = possibleRange->second;
-        if (long delta = input - entry.sourceStart; delta < entry.length) {
-          // we're in range
-          output = entry.destStart + delta;
-        }
-      }
-      inputs[i] = output;
-      ++i;
-    }
+std::string snapshot(const Almanac &almanac) {
+  auto stages = stage(almanac);
+  aoc::snapshot::writer out("05", version);
+  out.add(seeds_tag, stages.seeds);
+  out.add(bounds_tag, stages.bounds);
+  out.add(entries_tag, stages.entries);
+  return out.finish();
+}
 
-    // walk to next category
-    seenCategories.insert(category);
-    category = categoryPath[category];
+Stages load(std::string_view snapshot) {
+  aoc::snapshot::reader in(snapshot, "05", version);
+  Stages stages{in.get<long>(seeds_tag), in.get<std::uint32_t>(bounds_tag),
+                in.get<MapEntry>(entries_tag)};
+  if (stages.bounds.empty() || stages.bounds.front() != 0 ||
+      stages.bounds.back() != stages.entries.size() ||
+      !std::ranges::is_sorted(stages.bounds)) {
+    throw std::runtime_error("bad snapshot: stage bounds");
   }
 
-  return *std::ranges::min_element(inputs.begin(), inputs.end());
+  return stages;
 }
 
-int part2(std::istream &input) {
-  auto it = std::istreambuf_iterator(input);
-  std::string in(it, {});
-  auto res = lexy::parse<grammar::production<true>>(lexy::string_input(in),
-                                                    lexy_ext::report_error);
-  if (!res.has_value()) {
-    throw std::runtime_error("failed to parse");
+int part1(const Stages &stages) {
+  AOC_SCOPE("05/part1");
+  if (stages.seeds.empty()) {
+    throw std::runtime_error("no seeds");
   }
 
-  auto almanac = res.value();
-  std::map<std::string, std::string> categoryPath;
-
-  std::map<std::string, std::map<long, std::pair<long, long>>> indexes;
-  for (auto map : almanac.mappings) {
-    categoryPath.emplace(map.source, map.dest);
-    std::map<long, std::pair<long, long>> sourceIndex;
-
-    long lastEnd = 0;
-    std::ranges::sort(map.entries, [](auto a, auto b) {
-      return a.sourceStart < b.sourceStart;
-    });
-    for (auto entry : map.entries) {
-      // [last, this)
-      if (entry.sourceStart > lastEnd) {
-        sourceIndex.emplace(lastEnd,
-                            std::make_pair(lastEnd, entry.sourceStart));
+  std::vector<long> values(stages.seeds.begin(), stages.seeds.end());
+  for (std::size_t i = 0; i < stages.size(); ++i) {
+    auto stage = stages.stage(i);
+    for (auto &value : values) {
+      // the last entry starting at or before the value is the only candidate
+      auto after = std::ranges::upper_bound(stage, value, {},
+                                            &MapEntry::sourceStart);
+      if (after == stage.begin()) {
+        continue;
       }
-      // [this, this end)
-      sourceIndex.emplace(
-          entry.sourceStart,
-          std::make_pair(entry.destStart, entry.destStart + entry.length));
 
-      lastEnd = entry.sourceStart + entry.length;
+      auto entry = *std::prev(after);
+      if (long delta = value - entry.sourceStart; delta < entry.length) {
+        value = entry.destStart + delta;
+      }
     }
-    // [last, max)
-    sourceIndex.emplace(lastEnd, std::make_pair(lastEnd, LONG_MAX));
-    indexes.emplace(map.source, sourceIndex);
   }
 
-  std::set<std::string> seenCategories;
-  auto startCategory = almanac.input == "seeds" ? "seed" : almanac.input;
-  auto category = startCategory;
-  constexpr auto targetCategory = "location";
+  return *std::ranges::min_element(values);
+}
 
-  auto inputs = almanac.inputs;
-  for (auto &input : inputs) {
-    input.second = input.first + input.second;
+int part2(const Stages &stages) {
+  AOC_SCOPE("05/part2");
+  if (stages.seeds.empty() || stages.seeds.size() % 2 != 0) {
+    throw std::runtime_error("seed ranges must come in pairs");
   }
 
-  while (category != targetCategory) {
-    std::vector<std::pair<long, long>> nextInputs;
-
-    if (seenCategories.contains(category)) {
-      throw std::runtime_error("category " + category + " traversed already");
-    }
-
-    auto index = indexes[category];
-    std::ranges::sort(inputs, [](auto a, auto b) { return a.first < b.first; });
-    for (auto input : inputs) {
-      auto [inputLeft, inputRight] = input;
-
-      auto startIt = index.lower_bound(inputLeft);
-      auto endIt = index.lower_bound(inputRight);
+  // half-open ranges, split wherever an entry starts or ends inside one
+  std::vector<std::pair<long, long>> ranges, next;
+  for (std::size_t i = 0; i < stages.seeds.size(); i += 2) {
+    ranges.emplace_back(stages.seeds[i],
+                        stages.seeds[i] + stages.seeds[i + 1]);
+  }
 
-      if (startIt->first != inputLeft || startIt != index.begin()) {
-        --startIt;
+  for (std::size_t i = 0; i < stages.size(); ++i) {
+    auto stage = stages.stage(i);
+    next.clear();
+    for (auto [low, high] : ranges) {
+      auto entry = std::ranges::upper_bound(stage, low, {},
+                                            &MapEntry::sourceStart);
+      if (entry != stage.begin()) {
+        --entry;
       }
 
-      for (auto range : std::ranges::subrange(startIt, endIt)) {
-        auto [sourceLeft, destRange] = range;
-        auto [destLeft, destRight] = destRange;
-
-        // compute destination left bound
-        long lowerBound = std::max(sourceLeft, inputLeft);
-        long delta = lowerBound - sourceLeft;
-        long newDestLeft = destLeft + delta;
-
-        // compute destination right bound
-        long length =
-            (destRight == LONG_MAX ? inputRight // we're in the source space if
-                                                // we're on the trailing range
-                                   : destRight) -
-            destLeft;
+      for (; entry != stage.end() && low < high; ++entry) {
+        long start = entry->sourceStart, end = start + entry->length;
+        if (end <= low) {
+          continue;
+        }
+        if (start >= high) {
+          break;
+        }
 
-        if (length > 0) {
-          long sourceRight = sourceLeft + length;
-          long upperBound = std::min(sourceRight, inputRight);
+        // values between entries map to themselves
+        if (start > low) {
+          next.emplace_back(low, start);
+          low = start;
+        }
 
-          long rightDelta = upperBound - sourceLeft;
-          long newDestRight = destLeft + rightDelta;
+        long stop = std::min(end, high);
+        next.emplace_back(entry->destStart + (low - start),
+                          entry->destStart + (stop - start));
+        low = stop;
+      }
 
-          nextInputs.emplace_back(newDestLeft, newDestRight);
-        }
+      if (low < high) {
+        next.emplace_back(low, high);
       }
     }
-
-    // walk to next category
-    seenCategories.insert(category);
-    category = categoryPath[category];
-    inputs = nextInputs;
+    std::swap(ranges, next);
   }
 
-  std::ranges::sort(inputs, [](auto a, auto b) { return a.first < b.first; });
-  return inputs[0].first;
+  return std::ranges::min(ranges).first;
+}
+
+int part1(std::string_view input) {
+  aoc::arena arena;
+  return part1(parse(input, arena));
 }
+
+int part1(std::istream &input) { return part1(std::string_view(slurp(input))); }
+
+int part2(std::string_view input) {
+  aoc::arena arena;
+  return part2(parse(input, arena));
+}
+
+int part2(std::istream &input) { return part2(std::string_view(slurp(input))); }
+} // namespace day05
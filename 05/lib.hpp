@@ -1,5 +1,68 @@
 #pragma once
+#include "../common/arena.hpp"
+
+#include <cstdint>
 #include <istream>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace day05 {
+// Keys cached answers and snapshots; see aoc::cache::key before bumping.
+inline constexpr int version = 1;
+
+struct MapEntry {
+  long destStart;
+  long sourceStart;
+  long length;
+};
+
+struct Mapping {
+  std::pmr::string source;
+  std::pmr::string dest;
+  std::pmr::vector<MapEntry> entries;
+};
+
+// The parsed almanac. Part 1 reads the seeds as single values and part 2 as
+// (start, length) pairs; both solvers only read the model.
+struct Almanac {
+  std::pmr::string input;
+  std::pmr::vector<long> seeds;
+  std::pmr::vector<Mapping> mappings;
+};
 
+// Parses the whole input into the arena, which must outlive the almanac.
+Almanac parse(std::string_view input, aoc::arena &arena);
+
+int part1(const Almanac &almanac);
 int part1(std::istream &input);
+int part1(std::string_view input);
+int part2(const Almanac &almanac);
 int part2(std::istream &input);
+int part2(std::string_view input);
+
+// The almanac as a snapshot keeps it: the seeds, then the maps in the order
+// they take seeds to locations, each sorted by source so a value finds its
+// entry by binary search. The spans point into the snapshot's bytes.
+struct Stages {
+  std::span<const long> seeds;
+  // stage i is entries[bounds[i], bounds[i + 1])
+  std::span<const std::uint32_t> bounds;
+  std::span<const MapEntry> entries;
+
+  std::size_t size() const { return bounds.size() - 1; }
+  std::span<const MapEntry> stage(std::size_t i) const {
+    return entries.subspan(bounds[i], bounds[i + 1] - bounds[i]);
+  }
+};
+
+// Writes the almanac as a snapshot (see common/snapshot.hpp), and reads one
+// back in place, throwing if it isn't a snapshot of this version of day 05.
+std::string snapshot(const Almanac &almanac);
+Stages load(std::string_view snapshot);
+
+int part1(const Stages &stages);
+int part2(const Stages &stages);
+} // namespace day05
@@ -1,15 +1,29 @@
+#include "../common/cache.hpp"
+#include "../common/input.hpp"
 #include "lib.hpp"
 
-#include <fstream>
 #include <iostream>
+#include <optional>
 
 int main() {
-  std::ifstream input_file("input");
+  aoc::mapped_file input_file("input");
 
   if (input_file.is_open()) {
-    std::cout << "part1: " << part1(input_file) << std::endl;
-    input_file.clear();
-    input_file.seekg(0, std::iostream::beg);
-    std::cout << "part2: " << part2(input_file) << std::endl;
+    aoc::cache::answers answers("05", day05::version, input_file.view());
+    aoc::arena arena;
+    std::optional<day05::Almanac> almanac;
+    auto model = [&]() -> const day05::Almanac & {
+      if (!almanac) {
+        almanac.emplace(day05::parse(input_file.view(), arena));
+      }
+      return *almanac;
+    };
+
+    std::cout << "part1: "
+              << answers.get("1", [&] { return day05::part1(model()); })
+              << std::endl;
+    std::cout << "part2: "
+              << answers.get("2", [&] { return day05::part2(model()); })
+              << std::endl;
   }
 }
@@ -1,7 +1,11 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "lib.hpp"
+#include "../common/alloc.hpp"
+#include "../common/snapshot.hpp"
 #include <doctest/doctest.h>
 
+using namespace day05;
+
 TEST_CASE("05-part1") {
   constexpr auto example = R"EOF(
 seeds: 79 14 55 13
@@ -40,6 +44,7 @@ humidity-to-location map:
 )EOF";
   std::stringstream ss(1 + example);
   CHECK(part1(ss) == 35);
+  CHECK(part1(std::string_view(1 + example)) == 35);
 }
 
 TEST_CASE("05-part2") {
@@ -81,3 +86,173 @@ humidity-to-location map:
   std::stringstream ss(1 + example);
   CHECK(part2(ss) == 46);
 }
+
+TEST_CASE("05-parse") {
+  constexpr auto example = R"EOF(
+seeds: 79 14 55 13
+
+seed-to-soil map:
+50 98 2
+52 50 48
+
+soil-to-fertilizer map:
+0 15 37
+37 52 2
+39 0 15
+
+fertilizer-to-water map:
+49 53 8
+0 11 42
+42 0 7
+57 7 4
+
+water-to-light map:
+88 18 7
+18 25 70
+
+light-to-temperature map:
+45 77 23
+81 45 19
+68 64 13
+
+temperature-to-humidity map:
+0 69 1
+1 0 69
+
+humidity-to-location map:
+60 56 37
+56 93 4
+)EOF";
+  aoc::arena arena;
+  auto almanac = parse(1 + example, arena);
+  CHECK(almanac.input == "seeds");
+  CHECK(almanac.seeds.size() == 4);
+  REQUIRE(almanac.mappings.size() == 7);
+  CHECK(almanac.mappings[0].source == "seed");
+  CHECK(almanac.mappings[0].dest == "soil");
+  CHECK(almanac.mappings[2].entries.size() == 4);
+
+  CHECK(part1(almanac) == 35);
+  CHECK(part2(almanac) == 46);
+
+  // part 2 needs the seeds in pairs
+  auto odd = parse("seeds: 1 2 3\n\nseed-to-location map:\n1 2 3\n", arena);
+  CHECK_THROWS(part2(odd));
+}
+
+TEST_CASE("05-snapshot") {
+  constexpr auto example = R"EOF(
+seeds: 79 14 55 13
+
+seed-to-soil map:
+50 98 2
+52 50 48
+
+soil-to-fertilizer map:
+0 15 37
+37 52 2
+39 0 15
+
+fertilizer-to-water map:
+49 53 8
+0 11 42
+42 0 7
+57 7 4
+
+water-to-light map:
+88 18 7
+18 25 70
+
+light-to-temperature map:
+45 77 23
+81 45 19
+68 64 13
+
+temperature-to-humidity map:
+0 69 1
+1 0 69
+
+humidity-to-location map:
+60 56 37
+56 93 4
+)EOF";
+  aoc::arena arena;
+  auto bytes = snapshot(parse(1 + example, arena));
+  auto stages = load(bytes);
+  CHECK(stages.seeds.size() == 4);
+  REQUIRE(stages.size() == 7);
+  CHECK(stages.stage(0).size() == 2);
+  CHECK(stages.stage(0)[0].sourceStart == 50);
+  CHECK(part1(stages) == 35);
+  CHECK(part2(stages) == 46);
+
+  // only whole snapshots of this day and version are read
+  CHECK(aoc::snapshot::is_snapshot(bytes));
+  CHECK_FALSE(aoc::snapshot::is_snapshot(1 + example));
+  CHECK_THROWS(load(bytes.substr(0, bytes.size() - 1)));
+  CHECK_THROWS(aoc::snapshot::reader(bytes, "05", version + 1));
+  CHECK_THROWS(aoc::snapshot::reader(bytes, "04", version));
+
+  // the maps have to lead from seeds to locations
+  auto stuck = parse("seeds: 1 2\n\nseed-to-soil map:\n1 2 3\n", arena);
+  CHECK_THROWS(snapshot(stuck));
+}
+
+#ifdef AOC_TRACK_ALLOC
+// The almanac parses into the arena's inline buffer, so the parse allocates
+// nothing; the solvers allocate the stages and their range lists.
+TEST_CASE("05-allocations") {
+  constexpr auto example = R"EOF(
+seeds: 79 14 55 13
+
+seed-to-soil map:
+50 98 2
+52 50 48
+
+soil-to-fertilizer map:
+0 15 37
+37 52 2
+39 0 15
+
+fertilizer-to-water map:
+49 53 8
+0 11 42
+42 0 7
+57 7 4
+
+water-to-light map:
+88 18 7
+18 25 70
+
+light-to-temperature map:
+45 77 23
+81 45 19
+68 64 13
+
+temperature-to-humidity map:
+0 69 1
+1 0 69
+
+humidity-to-location map:
+60 56 37
+56 93 4
+)EOF";
+  REQUIRE(aoc::alloc::tracking());
+  auto input = std::string_view(1 + example);
+
+  aoc::arena arena;
+  auto [almanac, parse_used] =
+      aoc::alloc::measure([&] { return parse(input, arena); });
+  CHECK(aoc::alloc::within(parse_used, {}));
+
+  auto [part1_answer, part1_used] =
+      aoc::alloc::measure([&] { return part1(almanac); });
+  CHECK(part1_answer == 35);
+  CHECK(aoc::alloc::within(part1_used, {.count = 40, .peak = 2048}));
+
+  auto [part2_answer, part2_used] =
+      aoc::alloc::measure([&] { return part2(almanac); });
+  CHECK(part2_answer == 46);
+  CHECK(aoc::alloc::within(part2_used, {.count = 48, .peak = 2048}));
+}
+#endif
@@ -0,0 +1,120 @@
+#pragma once
+#include "../common/input.hpp"
+#include "../common/integer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+// The race solver with no allocation, so it runs in constant expressions. A
+// sheet is sized by its column count, which is itself a constant expression:
+//
+//   constexpr std::string_view input = "Time: 7 15 30\nDistance: 9 40 200";
+//   constexpr auto sheet = day06::constant::parse<columns(input)>(input);
+//   static_assert(day06::constant::part1(sheet) == 288);
+namespace day06::constant {
+template <std::size_t Columns> struct Sheet {
+  std::array<long, Columns> times{};
+  std::array<long, Columns> distances{};
+};
+
+// The numbers on the sheet's first row.
+constexpr std::size_t columns(std::string_view input) {
+  std::size_t count = 0;
+  auto first = *aoc::lines(input).begin();
+  aoc::integer::parse_each<long>(first.substr(first.find(':') + 1),
+                                 [&count](long) { ++count; });
+  return count;
+}
+
+namespace detail {
+template <std::size_t Columns>
+constexpr void row(std::string_view line, std::string_view label,
+                   std::array<long, Columns> &out) {
+  if (!line.starts_with(label)) {
+    throw std::runtime_error("failed to parse");
+  }
+
+  std::size_t count = 0;
+  bool numbers = aoc::integer::parse_each<long>(
+      line.substr(label.size()), [&](long n) {
+        if (count < Columns) {
+          out[count] = n;
+        }
+        ++count;
+      });
+  if (!numbers || count != Columns) {
+    throw std::runtime_error("failed to parse");
+  }
+}
+
+// n with its digits appended to value's, as part 2 reads a row.
+constexpr long join(long value, long n) {
+  long scale = 10;
+  while (scale <= n) {
+    scale *= 10;
+  }
+
+  if (__builtin_mul_overflow(value, scale, &value) ||
+      __builtin_add_overflow(value, n, &value)) {
+    throw std::out_of_range("kerned number does not fit in a long");
+  }
+
+  return value;
+}
+} // namespace detail
+
+template <std::size_t Columns>
+constexpr Sheet<Columns> parse(std::string_view input) {
+  Sheet<Columns> sheet;
+  aoc::lines lines(input);
+  auto line = lines.begin();
+  if (line == lines.end()) {
+    throw std::runtime_error("failed to parse");
+  }
+  detail::row(*line, "Time:", sheet.times);
+
+  if (++line == lines.end()) {
+    throw std::runtime_error("failed to parse");
+  }
+  detail::row(*line, "Distance:", sheet.distances);
+  return sheet;
+}
+
+// How many ways there are to beat the best distance. Holding for t goes
+// t * (time - t), which rises to the middle and falls symmetrically, so
+// counting is a binary search for the shortest winning hold.
+constexpr long wins(long time, long best_distance) {
+  long lo = 0, hi = time / 2 + 1;
+  while (lo < hi) {
+    long t = lo + (hi - lo) / 2;
+    if (t * (time - t) > best_distance) {
+      hi = t;
+    } else {
+      lo = t + 1;
+    }
+  }
+
+  return lo > time / 2 ? 0 : time - 2 * lo + 1;
+}
+
+template <std::size_t Columns>
+constexpr long part1(const Sheet<Columns> &sheet) {
+  long total = 1;
+  for (std::size_t i = 0; i < Columns; ++i) {
+    total *= wins(sheet.times[i], sheet.distances[i]);
+  }
+  return total;
+}
+
+template <std::size_t Columns>
+constexpr long part2(const Sheet<Columns> &sheet) {
+  long time = 0, distance = 0;
+  for (std::size_t i = 0; i < Columns; ++i) {
+    time = detail::join(time, sheet.times[i]);
+    distance = detail::join(distance, sheet.distances[i]);
+  }
+  return wins(time, distance);
+}
+} // namespace day06::constant
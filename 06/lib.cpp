@@ -1,31 +1,35 @@
+#include "lib.hpp"
+#include "constant.hpp"
+#include "../common/instrument.hpp"
+#include "../common/integer.hpp"
+
 #include <lexy/callback.hpp>
 #include <lexy/callback/container.hpp>
 #include <lexy/dsl.hpp>
 
 #include <algorithm>
-#include <bits/ranges_algo.h>
 #include <iostream>
+#include <iterator>
 #include <lexy/action/parse.hpp>
 #include <lexy/input/string_input.hpp>
 #include <lexy_ext/report_error.hpp>
 #include <ranges>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+namespace day06 {
 namespace {
-
-struct Race {
-  int time;
-  int distance;
-};
-
 namespace grammar {
 namespace dsl = lexy::dsl;
 
 struct numbers {
-  static constexpr auto rule = dsl::list(dsl::integer<int>);
+  static constexpr auto rule = dsl::list(dsl::integer<long>);
 
-  static constexpr auto value = lexy::as_list<std::vector<int>>;
+  static constexpr auto value =
+      lexy::as_list<std::pmr::vector<long>>.allocator();
 };
 
 struct production {
@@ -37,95 +41,70 @@ struct production {
 
   static constexpr auto whitespace = dsl::ascii::blank;
 
-  static constexpr auto value = lexy::callback<std::vector<Race>>(
-      [](std::vector<int> times, std::vector<int> distances) {
-        std::vector<Race> rv;
-
-        std::ranges::transform(times, distances, std::back_inserter(rv),
-                               [](auto time, auto distance) {
-                                 return Race{time, distance};
-                               });
-
-        return rv;
-      });
+  static constexpr auto value = lexy::construct<Races>;
 };
 } // namespace grammar
 
-namespace grammar2 {
-namespace dsl = lexy::dsl;
-
-struct numbers {
-  static constexpr auto rule = dsl::list(dsl::integer<long>);
-
-  static constexpr auto value =
-      lexy::fold<std::string>("",
-                              [](std::string in, long n) {
-                                return in + std::to_string(n);
-                              }) >>
-      lexy::callback<long>([](std::string in) { return std::stol(in); });
-};
+// Reads a row with the spaces taken out, as part 2 wants it.
+long kerned(const std::pmr::vector<long> &row) {
+  std::string digits;
+  for (auto n : row) {
+    digits += std::to_string(n);
+  }
 
-struct production {
-  static constexpr auto rule = [] {
-    auto line1 = LEXY_LIT("Time:") + dsl::p<numbers> + dsl::newline;
-    auto line2 = LEXY_LIT("Distance:") + dsl::p<numbers>;
-    return line1 + line2;
-  }();
+  auto value = aoc::integer::parse<long>(digits);
+  if (!value) {
+    throw std::out_of_range("kerned number does not fit in a long: " + digits);
+  }
 
-  static constexpr auto whitespace = dsl::ascii::blank;
+  return *value;
+}
 
-  static constexpr auto value = lexy::construct<std::pair<long, long>>;
-};
-} // namespace grammar2
+std::string slurp(std::istream &input) {
+  auto it = std::istreambuf_iterator(input);
+  return std::string(it, {});
+}
 } // namespace
 
-int part1(std::istream &input) {
-  auto it = std::istreambuf_iterator(input);
-  std::string in(it, {});
-  auto res = lexy::parse<grammar::production>(lexy::string_input(in),
-                                              lexy_ext::report_error);
+Races parse(std::string_view input, aoc::arena &arena) {
+  AOC_SCOPE("06/parse");
+  auto res = lexy::parse<grammar::production>(
+      lexy::string_input(input), arena.allocator(), lexy_ext::report_error);
   if (!res.has_value()) {
     throw std::runtime_error("failed to parse");
   }
 
-  auto races = res.value();
+  return std::move(res).value();
+}
+
+int part1(const Races &races) {
+  AOC_SCOPE("06/part1");
+  auto count = std::min(races.times.size(), races.distances.size());
   int total = 1;
-  for (auto [time, best_distance] : races) {
-    int win_count = 0;
-    for (int t = 0; t < time; ++t) {
-      int speed = t;
-      int remaining = time - t;
-      int distance = remaining * speed;
-
-      if (distance > best_distance) {
-        ++win_count;
-      }
-    }
-    total *= win_count;
+  for (std::size_t i = 0; i < count; ++i) {
+    total *= constant::wins(races.times[i], races.distances[i]);
   }
   return total;
 }
 
-long part2(std::istream &input) {
-  auto it = std::istreambuf_iterator(input);
-  std::string in(it, {});
-  auto res = lexy::parse<grammar2::production>(lexy::string_input(in),
-                                               lexy_ext::report_error);
-  if (!res.has_value()) {
-    throw std::runtime_error("failed to parse");
-  }
+long part2(const Races &races) {
+  AOC_SCOPE("06/part2");
+  return constant::wins(kerned(races.times), kerned(races.distances));
+}
 
-  long win_count = 0;
-  auto [time, best_distance] = res.value();
-  for (long t = 0; t < time; ++t) {
-    long speed = t;
-    long remaining = time - t;
-    long distance = remaining * speed;
+int part1(std::string_view input) {
+  aoc::arena arena;
+  return part1(parse(input, arena));
+}
 
-    if (distance > best_distance) {
-      ++win_count;
-    }
-  }
+long part2(std::string_view input) {
+  aoc::arena arena;
+  return part2(parse(input, arena));
+}
 
-  return win_count;
+int part1(std::istream &input) { return part1(std::string_view(slurp(input))); }
+
+long part2(std::istream &input) {
+  return part2(std::string_view(slurp(input)));
 }
+} // namespace day06
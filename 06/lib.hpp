@@ -1,5 +1,29 @@
 #pragma once
+#include "../common/arena.hpp"
+
 #include <istream>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace day06 {
+// Keys cached answers; see aoc::cache::key before bumping.
+inline constexpr int version = 1;
+
+// The race sheet's two rows as written. Part 1 reads them column by column,
+// part 2 joins each row's digits into one race.
+struct Races {
+  std::pmr::vector<long> times;
+  std::pmr::vector<long> distances;
+};
+
+// Parses the whole input into the arena, which must outlive the races.
+Races parse(std::string_view input, aoc::arena &arena);
 
+int part1(const Races &races);
 int part1(std::istream &input);
+int part1(std::string_view input);
+long part2(const Races &races);
 long part2(std::istream &input);
+long part2(std::string_view input);
+} // namespace day06
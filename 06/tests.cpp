@@ -1,7 +1,11 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "lib.hpp"
+#include "constant.hpp"
+#include "../common/alloc.hpp"
 #include <doctest/doctest.h>
 
+using namespace day06;
+
 TEST_CASE("06-part1") {
   constexpr auto example = R"EOF(
 Time:      7  15   30
@@ -9,6 +13,7 @@ Distance:  9  40  200
 )EOF";
   std::stringstream ss(1 + example);
   CHECK(part1(ss) == 288);
+  CHECK(part1(std::string_view(1 + example)) == 288);
 }
 
 TEST_CASE("06-part2") {
@@ -19,3 +24,66 @@ Distance:  9  40  200
   std::stringstream ss(1 + example);
   CHECK(part2(ss) == 71503);
 }
+
+TEST_CASE("06-parse") {
+  constexpr auto example = R"EOF(
+Time:      7  15   30
+Distance:  9  40  200
+)EOF";
+  aoc::arena arena;
+  auto races = parse(1 + example, arena);
+  CHECK(races.times.size() == 3);
+  CHECK(races.distances.size() == 3);
+  CHECK(races.distances[2] == 200);
+
+  CHECK(part1(races) == 288);
+  CHECK(part2(races) == 71503);
+}
+
+TEST_CASE("06-constant") {
+  constexpr std::string_view example = R"EOF(Time:      7  15   30
+Distance:  9  40  200
+)EOF";
+  using namespace day06::constant;
+  constexpr auto sheet = parse<columns(example)>(example);
+  static_assert(sheet.times.size() == 3 && sheet.distances[2] == 200);
+  static_assert(part1(sheet) == 288);
+  static_assert(part2(sheet) == 71503);
+
+  // the closed form agrees with counting every hold
+  for (long time = 0; time < 40; ++time) {
+    for (long best = 0; best < time * time / 4 + 2; ++best) {
+      long count = 0;
+      for (long t = 0; t <= time; ++t) {
+        count += t * (time - t) > best;
+      }
+      CHECK(wins(time, best) == count);
+    }
+  }
+
+  CHECK_THROWS(parse<3>("Time: 7 15\nDistance: 9 40 200\n"));
+  CHECK_THROWS(parse<1>("Time: 7\n"));
+}
+
+#ifdef AOC_TRACK_ALLOC
+// Both rows fit in the arena's inline buffer and the kerned digits in a short
+// string, so neither part touches the heap.
+TEST_CASE("06-allocations") {
+  constexpr auto example = R"EOF(
+Time:      7  15   30
+Distance:  9  40  200
+)EOF";
+  REQUIRE(aoc::alloc::tracking());
+  auto input = std::string_view(1 + example);
+
+  auto [part1_answer, part1_used] =
+      aoc::alloc::measure([&] { return part1(input); });
+  CHECK(part1_answer == 288);
+  CHECK(aoc::alloc::within(part1_used, {}));
+
+  auto [part2_answer, part2_used] =
+      aoc::alloc::measure([&] { return part2(input); });
+  CHECK(part2_answer == 71503);
+  CHECK(aoc::alloc::within(part2_used, {}));
+}
+#endif
@@ -0,0 +1,61 @@
+#include "hand.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+template <std::size_t N> std::vector<std::array<card_value, N>> deal(int n) {
+  std::mt19937 rng(N);
+  std::uniform_int_distribution<int> card(0, 13);
+
+  std::vector<std::array<card_value, N>> hands(n);
+  for (auto &hand : hands) {
+    for (auto &c : hand) {
+      c = static_cast<card_value>(card(rng));
+    }
+  }
+
+  return hands;
+}
+
+template <typename Classifier, std::size_t N>
+void run(const char *name, const std::vector<std::array<card_value, N>> &hands,
+         int rounds = 20) {
+  std::uint64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (const auto &hand : hands) {
+      checksum += Classifier::classify(hand);
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count() /
+              (static_cast<double>(hands.size()) * rounds);
+  std::cout << name << ": " << ns << " ns/hand (checksum " << checksum << ")"
+            << std::endl;
+}
+} // namespace
+
+int main() {
+  using enum card_value;
+  constexpr int n = 1 << 20;
+
+  auto hands3 = deal<3>(n);
+  run<classifier<3>>("3 cards", hands3);
+  run<classifier<3, joker>>("3 cards, jokers wild", hands3);
+
+  auto hands5 = deal<5>(n);
+  run<generic_classifier<5>>("5 cards, generic", hands5);
+  run<classifier<5>>("5 cards, table", hands5);
+  run<generic_classifier<5, joker>>("5 cards, jokers wild, generic", hands5);
+  run<classifier<5, joker>>("5 cards, jokers wild, table", hands5);
+  run<classifier<5, joker, two>>("5 cards, jokers and twos wild", hands5);
+
+  auto hands7 = deal<7>(n);
+  run<classifier<7>>("7 cards", hands7);
+  run<classifier<7, joker, two>>("7 cards, jokers and twos wild", hands7);
+}
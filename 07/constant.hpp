@@ -0,0 +1,118 @@
+#pragma once
+#include "../common/input.hpp"
+#include "../common/integer.hpp"
+#include "hand.hpp"
+#include "lib.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+// Hand ranking with no allocation, so it runs in constant expressions. Deals
+// are held in an array sized by the input's line count:
+//
+//   constexpr auto deals = day07::constant::parse<count(input)>(input);
+//   static_assert(day07::constant::part1(deals) == 6440);
+namespace day07::constant {
+template <std::size_t N> using Deals = std::array<Deal, N>;
+
+constexpr std::optional<card_value> card(char c) {
+  using enum card_value;
+  switch (c) {
+  case 'A':
+    return ace;
+  case 'K':
+    return king;
+  case 'Q':
+    return queen;
+  case 'J':
+    return jack;
+  case 'T':
+    return ten;
+  default:
+    if (c >= '2' && c <= '9') {
+      return static_cast<card_value>(c - '2' + static_cast<int>(two));
+    }
+    return std::nullopt;
+  }
+}
+
+// A "CCCCC bid" line, as the runtime parser's fast path reads it.
+constexpr Deal deal(std::string_view line) {
+  if (line.size() < 7 || line[5] != ' ') {
+    throw std::runtime_error("failed to parse line");
+  }
+
+  Deal deal{};
+  for (std::size_t i = 0; i < 5; ++i) {
+    auto value = card(line[i]);
+    if (!value) {
+      throw std::runtime_error("failed to parse line");
+    }
+    deal.cards[i] = *value;
+  }
+
+  auto bid = aoc::integer::parse<int>(line.substr(6));
+  if (!bid || *bid < 0) {
+    throw std::runtime_error("failed to parse line");
+  }
+  deal.bid = *bid;
+  return deal;
+}
+
+constexpr std::size_t count(std::string_view input) {
+  std::size_t count = 0;
+  for ([[maybe_unused]] auto line : aoc::lines(input)) {
+    ++count;
+  }
+  return count;
+}
+
+template <std::size_t N> constexpr Deals<N> parse(std::string_view input) {
+  Deals<N> deals{};
+  std::size_t i = 0;
+  for (auto line : aoc::lines(input)) {
+    if (i == N) {
+      throw std::runtime_error("more deals than counted");
+    }
+    deals[i++] = deal(line);
+  }
+  return deals;
+}
+
+// Ranks the hands by packed key, weakest first, and totals the winnings.
+template <bool Jokers, std::size_t N>
+constexpr long winnings(const Deals<N> &deals) {
+  std::array<Ranked, N> ranked{};
+  for (std::size_t i = 0; i < N; ++i) {
+    auto cards = deals[i].cards;
+    std::uint64_t key;
+    if constexpr (Jokers) {
+      std::ranges::replace(cards, card_value::jack, card_value::joker);
+      key = BasicHand<5, card_value::joker>(cards).key();
+    } else {
+      key = BasicHand<5>(cards).key();
+    }
+    ranked[i] = {static_cast<std::uint32_t>(key), deals[i].bid};
+  }
+
+  std::ranges::sort(ranked, {}, &Ranked::key);
+  long total = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    total += ranked[i].bid * static_cast<long>(i + 1);
+  }
+  return total;
+}
+
+template <std::size_t N> constexpr long part1(const Deals<N> &deals) {
+  return winnings<false>(deals);
+}
+
+template <std::size_t N> constexpr long part2(const Deals<N> &deals) {
+  return winnings<true>(deals);
+}
+} // namespace day07::constant
@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+enum class card_value {
+  joker,
+  two,
+  three,
+  four,
+  five,
+  six,
+  seven,
+  eight,
+  nine,
+  ten,
+  jack,
+  queen,
+  king,
+  ace,
+};
+
+enum class hand_value {
+  high,
+  pair,
+  two_pair,
+  three_of_a_kind,
+  full_house,
+  four_of_a_kind,
+  five_of_a_kind,
+};
+
+// Hands are classified from two counts that need no branches to compute: the
+// number of jokers held, and the number of equal pairs among the other cards.
+// That key is enough to tell every hand type apart under both rulesets, so
+// classification is a single lookup into one of the tables below.
+using hand_table = std::array<hand_value, 6 * 11>;
+
+constexpr hand_value classify(int largest, int groups) {
+  using enum hand_value;
+
+  switch (largest) {
+  case 5:
+    return five_of_a_kind;
+  case 4:
+    return four_of_a_kind;
+  case 3:
+    return groups == 2 ? full_house : three_of_a_kind;
+  case 2:
+    return groups == 3 ? two_pair : pair;
+  default:
+    return high;
+  }
+}
+
+// Enumerates every hand over a joker and five ordinary ranks, which covers
+// every card-count signature a real hand can have.
+template <bool Jokers> constexpr hand_table make_hand_table() {
+  constexpr int ranks = 6;
+  hand_table table{};
+
+  for (int n = 0; n < ranks * ranks * ranks * ranks * ranks; ++n) {
+    std::array<int, ranks> counts{};
+    for (int i = 0, m = n; i < 5; ++i, m /= ranks) {
+      counts[m % ranks]++;
+    }
+
+    int jokers = counts[0];
+    int pairs = 0, largest = 0, groups = 0;
+    for (int c = 1; c < ranks; ++c) {
+      pairs += counts[c] * (counts[c] - 1) / 2;
+      largest = std::max(largest, counts[c]);
+      groups += counts[c] > 0;
+    }
+
+    if (Jokers) {
+      largest += jokers;
+      groups = std::max(groups, 1);
+    } else if (jokers > 0) {
+      largest = std::max(largest, jokers);
+      ++groups;
+    }
+
+    table[jokers * 11 + pairs] = classify(largest, groups);
+  }
+
+  return table;
+}
+
+constexpr auto standard_hands = make_hand_table<false>();
+constexpr auto joker_hands = make_hand_table<true>();
+
+constexpr std::size_t hand_index(const std::array<card_value, 5> &h) {
+  auto joker = [](card_value a) {
+    return static_cast<int>(a == card_value::joker);
+  };
+  auto same = [](card_value a, card_value b) {
+    return static_cast<int>(a == b && a != card_value::joker);
+  };
+
+  int jokers = joker(h[0]) + joker(h[1]) + joker(h[2]) + joker(h[3]) +
+               joker(h[4]);
+  int pairs = same(h[0], h[1]) + same(h[0], h[2]) + same(h[0], h[3]) +
+              same(h[0], h[4]) + same(h[1], h[2]) + same(h[1], h[3]) +
+              same(h[1], h[4]) + same(h[2], h[3]) + same(h[2], h[4]) +
+              same(h[3], h[4]);
+
+  return jokers * 11 + pairs;
+}
+
+// Ranks hands of any size by their card-count signature. Every rank held adds
+// (N + 1)^count, so signatures compare like the group sizes sorted largest
+// first, which is how hand types are ordered. Wild cards join the largest
+// group.
+template <std::size_t N, card_value... Wild> struct generic_classifier {
+  static_assert(N >= 1 && N <= 9, "signatures must fit in 32 bits");
+
+  static constexpr std::size_t ranks = 14;
+
+  static constexpr auto weights = [] {
+    std::array<std::uint32_t, N + 1> w{};
+    for (std::uint32_t i = 1, p = N + 1; i <= N; ++i, p *= N + 1) {
+      w[i] = p;
+    }
+    return w;
+  }();
+
+  static constexpr std::uint32_t
+  classify(const std::array<card_value, N> &cards) {
+    std::array<std::uint8_t, ranks> counts{};
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (counts[static_cast<std::size_t>(cards[I])]++, ...);
+    }(std::make_index_sequence<N>{});
+
+    std::size_t wild =
+        (std::size_t{0} + ... +
+         std::exchange(counts[static_cast<std::size_t>(Wild)], 0));
+
+    std::uint8_t largest = 0;
+    std::uint32_t signature = 0;
+    [&]<std::size_t... R>(std::index_sequence<R...>) {
+      ((largest = std::max(largest, counts[R]),
+        signature += weights[counts[R]]),
+       ...);
+    }(std::make_index_sequence<ranks>{});
+
+    return signature - weights[largest] + weights[largest + wild];
+  }
+};
+
+template <std::size_t N, card_value... Wild>
+struct classifier : generic_classifier<N, Wild...> {};
+
+// The five card rulesets from the puzzle classify through the lookup tables
+// and report a hand_value.
+template <> struct classifier<5> {
+  static constexpr std::uint32_t
+  classify(const std::array<card_value, 5> &cards) {
+    return static_cast<std::uint32_t>(standard_hands[hand_index(cards)]);
+  }
+};
+
+template <> struct classifier<5, card_value::joker> {
+  static constexpr std::uint32_t
+  classify(const std::array<card_value, 5> &cards) {
+    return static_cast<std::uint32_t>(joker_hands[hand_index(cards)]);
+  }
+};
+
+template <std::size_t N, card_value... Wild> class BasicHand {
+public:
+  using cards_type = std::array<card_value, N>;
+
+  constexpr explicit BasicHand(const cards_type &cards)
+      : hand(cards), rank(classifier<N, Wild...>::classify(cards)) {}
+
+  constexpr bool operator<(const BasicHand &other) const {
+    if (this->rank == other.rank) {
+      return std::ranges::lexicographical_compare(this->hand, other.hand);
+    }
+
+    return this->rank < other.rank;
+  }
+
+  constexpr std::uint32_t strength() const { return rank; }
+  constexpr const cards_type &cards() const { return hand; }
+
+  // Packs the hand into an integer that orders the same way hands do.
+  constexpr std::uint64_t key() const {
+    std::uint64_t k = this->rank;
+    for (auto card : this->hand) {
+      k = k * 14 + static_cast<std::uint64_t>(card);
+    }
+
+    return k;
+  }
+
+private:
+  cards_type hand;
+  std::uint32_t rank;
+};
@@ -1,121 +1,37 @@
+#include "lib.hpp"
+#include "hand.hpp"
+#include "../common/instrument.hpp"
+#include "../common/integer.hpp"
+#include "../common/snapshot.hpp"
+#include "../common/structural.hpp"
+
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <format>
 #include <istream>
+#include <iterator>
 #include <lexy/action/parse.hpp>
 #include <lexy/callback.hpp>
 #include <lexy/dsl.hpp>
 #include <lexy/input/string_input.hpp>
 #include <lexy/token.hpp>
 #include <lexy_ext/report_error.hpp>
-#include <map>
-#include <ranges>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
-enum class card_value {
-  joker,
-  two,
-  three,
-  four,
-  five,
-  six,
-  seven,
-  eight,
-  nine,
-  ten,
-  jack,
-  queen,
-  king,
-  ace,
-};
-
-enum class hand_value {
-  high,
-  pair,
-  two_pair,
-  three_of_a_kind,
-  full_house,
-  four_of_a_kind,
-  five_of_a_kind,
-};
-
-class Hand {
-public:
-  Hand(card_value a, card_value b, card_value c, card_value d, card_value e);
-  bool operator<(const Hand &other) const;
-
-private:
-  std::array<card_value, 5> hand;
-  std::vector<std::pair<card_value, int>> sets;
-  hand_value value;
-};
-
-Hand::Hand(card_value a, card_value b, card_value c, card_value d, card_value e)
-    : hand{a, b, c, d, e} {
-  using enum hand_value;
-  using enum card_value;
-
-  std::map<card_value, int> counts;
-  for (auto card : this->hand) {
-    counts.try_emplace(card, 0);
-    counts[card]++;
-  }
-
-  int jokers = 0;
-  if (const auto el = counts.find(joker); el != counts.end()) {
-    jokers = el->second;
-    counts.erase(el);
-  }
-
-  auto countsWithJokers = std::views::transform(counts, [jokers](auto el) {
-    el.second += jokers;
-    return el;
-  });
-
-  this->sets.insert(this->sets.end(), countsWithJokers.begin(),
-                    countsWithJokers.end());
-  std::ranges::sort(this->sets, [](const auto &a, const auto &b) {
-    return a.second == b.second ? a.first > b.first : a.second > b.second;
-  });
-
-  switch (this->sets.size()) {
-  case 0:
-    // all jokers
-    this->value = five_of_a_kind;
-    break;
-  case 1:
-    this->value = five_of_a_kind;
-    break;
-  case 2: {
-    auto [card, count] = sets[0];
-    if (count == 4) {
-      this->value = four_of_a_kind;
-    } else {
-      this->value = full_house;
-    }
-  } break;
-  case 3: {
-    auto [card, count] = sets[0];
-    if (count == 3) {
-      this->value = three_of_a_kind;
-    } else {
-      this->value = two_pair;
-    }
-  } break;
-  case 4:
-    this->value = pair;
-    break;
-  default:
-    this->value = high;
-  }
-}
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
 
-bool Hand::operator<(const Hand &other) const {
-  if (this->value == other.value) {
-    return std::ranges::lexicographical_compare(this->hand, other.hand);
-  }
-
-  return this->value < other.value;
-}
+namespace day07 {
+// Every hand's packed key is below this: seven hand types by five cards.
+constexpr std::uint32_t hand_keys = 7 * 14 * 14 * 14 * 14 * 14;
 
 namespace {
 namespace grammar {
@@ -140,6 +56,8 @@ template <> struct card_mapping<false> {
         .map<LEXY_SYMBOL('Q')>(queen)
         .map<LEXY_SYMBOL('K')>(king)
         .map<LEXY_SYMBOL('A')>(ace) ;
+
+  using hand_type = BasicHand<5>;
 };
 
 template <> struct card_mapping<true> {
@@ -159,6 +77,8 @@ template <> struct card_mapping<true> {
         .map<LEXY_SYMBOL('Q')>(queen)
         .map<LEXY_SYMBOL('K')>(king)
         .map<LEXY_SYMBOL('A')>(ace) ;
+
+  using hand_type = BasicHand<5, card_value::joker>;
 };
 
 template <bool P2> struct hand {
@@ -172,35 +92,149 @@ template <bool P2> struct hand {
                                dsl::symbol<card>(dsl::ascii::alnum) +
                                dsl::symbol<card>(dsl::ascii::alnum);
 
-  static constexpr auto value = lexy::construct<Hand>;
+  using hand_type = typename card_mapping<P2>::hand_type;
+
+  static constexpr auto value = lexy::callback<hand_type>(
+      [](card_value a, card_value b, card_value c, card_value d,
+         card_value e) { return hand_type({a, b, c, d, e}); });
 };
 
-template <bool P2> struct production {
+// Parses cards under the standard ruleset; the joker ruleset only differs in
+// how jacks are valued, so both can be derived from one parse.
+struct deal {
+  static constexpr auto card = card_mapping<false>::table;
+
   static constexpr auto whitespace = dsl::ascii::blank;
 
-  static constexpr auto rule = dsl::p<hand<P2>> + dsl::integer<int>;
+  static constexpr auto rule =
+      dsl::symbol<card>(dsl::ascii::alnum) +
+      dsl::symbol<card>(dsl::ascii::alnum) +
+      dsl::symbol<card>(dsl::ascii::alnum) +
+      dsl::symbol<card>(dsl::ascii::alnum) +
+      dsl::symbol<card>(dsl::ascii::alnum) + dsl::integer<int>;
 
-  static constexpr auto value = lexy::construct<std::pair<Hand, int>>;
+  static constexpr auto value = lexy::callback<Deal>(
+      [](card_value a, card_value b, card_value c, card_value d, card_value e,
+         int bid) { return Deal{{a, b, c, d, e}, bid}; });
 };
-} // namespace grammar
-} // namespace
 
-long part1(std::istream &input) {
-  std::string line;
+// The whole input in one parse, for when the fast path gives up. Deals go
+// straight into the list sink, and errors are reported against their line in
+// the file.
+struct deals {
+  static constexpr auto rule =
+      dsl::terminator(dsl::eof).opt_list(dsl::p<deal> + dsl::eol);
+
+  static constexpr auto value = lexy::as_list<Deals>.allocator();
+};
 
-  std::vector<std::pair<Hand, int>> hands;
-  while (std::getline(input, line)) {
-    auto str = lexy::string_input(line);
-    auto result =
-        lexy::parse<grammar::production<false>>(str, lexy_ext::report_error);
+template <bool P2> struct single_hand {
+  static constexpr auto rule = dsl::p<hand<P2>> + dsl::eof;
 
-    if (!result) {
-      throw std::runtime_error(std::format("failed to parse line: {}", line));
+  static constexpr auto value =
+      lexy::forward<typename card_mapping<P2>::hand_type>;
+};
+} // namespace grammar
+
+// Fast path for the fixed-width "CCCCC bid" line format. Cards are mapped to
+// ranks by looking up both nibbles of each byte: one pair of tables flags
+// valid card characters, and another pair sums to the card's value. With
+// SSSE3 the lookups are pshufb shuffles over all five bytes at once.
+namespace fast {
+// bit 1: '2'-'9', bit 2: 'A' 'J' 'K', bit 4: 'Q' 'T'
+constexpr std::array<std::uint8_t, 16> valid_lo = {
+    0, 6, 1, 1, 5, 1, 1, 1, 1, 1, 2, 2, 0, 0, 0, 0};
+constexpr std::array<std::uint8_t, 16> valid_hi = {
+    0, 0, 0, 1, 2, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+constexpr std::array<std::uint8_t, 16> rank_lo = {
+    0, 5, 1, 2, 3, 4, 5, 6, 7, 8, 2, 4, 0, 0, 0, 0};
+constexpr std::array<std::uint8_t, 16> rank_hi = {
+    0, 0, 0, 0, 8, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+bool cards(const char *in, std::array<card_value, 5> &out) {
+#if defined(__SSSE3__)
+  std::uint64_t word = 0;
+  std::memcpy(&word, in, 5);
+
+  auto table = [](const std::array<std::uint8_t, 16> &t) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(t.data()));
+  };
+
+  auto bytes = _mm_cvtsi64_si128(static_cast<long long>(word));
+  auto nibble = _mm_set1_epi8(0x0F);
+  auto lo = _mm_and_si128(bytes, nibble);
+  auto hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble);
+
+  auto valid = _mm_and_si128(_mm_shuffle_epi8(table(valid_lo), lo),
+                             _mm_shuffle_epi8(table(valid_hi), hi));
+  auto invalid = _mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128()));
+  if ((invalid & 0x1F) != 0) {
+    return false;
+  }
+
+  alignas(16) std::array<std::uint8_t, 16> ranks;
+  _mm_store_si128(reinterpret_cast<__m128i *>(ranks.data()),
+                  _mm_add_epi8(_mm_shuffle_epi8(table(rank_lo), lo),
+                               _mm_shuffle_epi8(table(rank_hi), hi)));
+#else
+  std::array<std::uint8_t, 5> ranks;
+  for (int i = 0; i < 5; ++i) {
+    auto c = static_cast<std::uint8_t>(in[i]);
+    if ((valid_lo[c & 0x0F] & valid_hi[c >> 4]) == 0) {
+      return false;
     }
+    ranks[i] = rank_lo[c & 0x0F] + rank_hi[c >> 4];
+  }
+#endif
+
+  for (int i = 0; i < 5; ++i) {
+    out[i] = static_cast<card_value>(ranks[i]);
+  }
+
+  return true;
+}
+
+std::optional<Deal> deal(std::string_view line) {
+  if (line.size() < 7 || line[5] != ' ') {
+    return std::nullopt;
+  }
+
+  // the grammar has no negative bids
+  auto bid = aoc::integer::parse<int>(line.substr(6));
+  Deal deal;
+  if (!bid || *bid < 0 || !cards(line.data(), deal.cards)) {
+    return std::nullopt;
+  }
+
+  deal.bid = *bid;
+  return deal;
+}
+} // namespace fast
+
+template <bool P2> using Hand = typename grammar::card_mapping<P2>::hand_type;
+
+template <bool P2> Hand<P2> make_hand(std::array<card_value, 5> cards) {
+  if constexpr (P2) {
+    std::ranges::replace(cards, card_value::jack, card_value::joker);
+  }
+
+  return Hand<P2>(cards);
+}
 
-    hands.emplace_back(result.value());
+template <bool P2> Hand<P2> parse_hand(std::string_view str) {
+  auto result = lexy::parse<grammar::single_hand<P2>>(lexy::string_input(str),
+                                                      lexy_ext::report_error);
+
+  if (!result) {
+    throw std::runtime_error(std::format("failed to parse hand: {}", str));
   }
 
+  return result.value();
+}
+
+template <typename H> long winnings(std::vector<std::pair<H, int>> &hands) {
+  AOC_SCOPE("07/rank");
   std::ranges::sort(
       hands, [](const auto &a, const auto &b) { return a.first < b.first; });
 
@@ -214,31 +248,247 @@ long part1(std::istream &input) {
   return total;
 }
 
-long part2(std::istream &input) {
-  std::string line;
+template <bool P2> long solve(const Deals &deals) {
+  std::vector<std::pair<Hand<P2>, int>> hands;
+  hands.reserve(deals.size());
+  for (const auto &[cards, bid] : deals) {
+    hands.emplace_back(make_hand<P2>(cards), bid);
+  }
 
-  std::vector<std::pair<Hand, int>> hands;
-  while (std::getline(input, line)) {
-    auto str = lexy::string_input(line);
-    auto result =
-        lexy::parse<grammar::production<true>>(str, lexy_ext::report_error);
+  return winnings(hands);
+}
 
-    if (!result) {
-      throw std::runtime_error(std::format("failed to parse line: {}", line));
-    }
+Deal parse_deal(std::string_view line) {
+  if (auto deal = fast::deal(line)) {
+    return *deal;
+  }
+
+  // anything unusual goes through the grammar, which reports the error
+  auto result = lexy::parse<grammar::deal>(lexy::string_input(line),
+                                           lexy_ext::report_error);
 
-    hands.emplace_back(result.value());
+  if (!result) {
+    throw std::runtime_error(std::format("failed to parse line: {}", line));
   }
 
-  std::ranges::sort(
-      hands, [](const auto &a, const auto &b) { return a.first < b.first; });
+  return result.value();
+}
+
+// Reparses everything through the grammar once any line is unusual.
+Deals parse_slow(std::string_view input, aoc::arena &arena) {
+  auto result = lexy::parse<grammar::deals>(
+      lexy::string_input(input), arena.allocator(), lexy_ext::report_error);
+
+  if (!result.is_success()) {
+    throw std::runtime_error("failed to parse deals");
+  }
+
+  return std::move(result).value();
+}
+
+std::string slurp(std::istream &input) {
+  auto it = std::istreambuf_iterator(input);
+  return std::string(it, {});
+}
+
+constexpr auto standard_tag = aoc::snapshot::tag("rank");
+constexpr auto jokers_tag = aoc::snapshot::tag("jokr");
+
+// Packed keys order the same way hands do, so sorting by key ranks them.
+template <bool P2> std::vector<Ranked> rank(const Deals &deals) {
+  std::vector<Ranked> ranked;
+  ranked.reserve(deals.size());
+  for (const auto &[cards, bid] : deals) {
+    auto key = static_cast<std::uint32_t>(make_hand<P2>(cards).key());
+    ranked.push_back({key, bid});
+  }
+
+  std::ranges::sort(ranked, {}, &Ranked::key);
+  return ranked;
+}
 
+long winnings(std::span<const Ranked> ranked) {
+  AOC_SCOPE("07/rank");
   long total = 0;
-  for (int i = 1; const auto &p : hands) {
-    auto [hand, value] = p;
-    total += value * i;
+  for (long i = 1; const auto &hand : ranked) {
+    total += hand.bid * i;
     i++;
   }
 
   return total;
 }
+} // namespace
+
+Deals parse(std::string_view input, aoc::arena &arena) {
+  AOC_SCOPE("07/parse");
+  // one vectorized pass finds every line, so deals can be reserved up front
+  aoc::structural_index index(input);
+  Deals deals(arena.allocator());
+  deals.reserve(index.line_count());
+  for (std::size_t i = 0; i < index.line_count(); ++i) {
+    auto deal = fast::deal(index.line(i));
+    if (!deal) {
+      return parse_slow(input, arena);
+    }
+
+    deals.push_back(*deal);
+  }
+
+  return deals;
+}
+
+long part1(const Deals &deals) {
+  AOC_SCOPE("07/part1");
+  return solve<false>(deals);
+}
+
+long part2(const Deals &deals) {
+  AOC_SCOPE("07/part2");
+  return solve<true>(deals);
+}
+
+std::pair<long, long> parts(const Deals &deals) {
+  return {part1(deals), part2(deals)};
+}
+
+std::string snapshot(const Deals &deals) {
+  aoc::snapshot::writer out("07", version);
+  out.add(standard_tag, rank<false>(deals));
+  out.add(jokers_tag, rank<true>(deals));
+  return out.finish();
+}
+
+Rankings load(std::string_view snapshot) {
+  aoc::snapshot::reader in(snapshot, "07", version);
+  Rankings rankings{in.get<Ranked>(standard_tag), in.get<Ranked>(jokers_tag)};
+  if (rankings.standard.size() != rankings.jokers.size()) {
+    throw std::runtime_error("bad snapshot: rankings differ in length");
+  }
+
+  return rankings;
+}
+
+long part1(const Rankings &rankings) {
+  AOC_SCOPE("07/part1");
+  return winnings(rankings.standard);
+}
+
+long part2(const Rankings &rankings) {
+  AOC_SCOPE("07/part2");
+  return winnings(rankings.jokers);
+}
+
+long part1(std::istream &input) {
+  return part1(std::string_view(slurp(input)));
+}
+long part1(std::string_view input) {
+  aoc::arena arena;
+  return part1(parse(input, arena));
+}
+
+long part2(std::istream &input) {
+  return part2(std::string_view(slurp(input)));
+}
+long part2(std::string_view input) {
+  aoc::arena arena;
+  return part2(parse(input, arena));
+}
+
+std::pair<long, long> parts(std::string_view input) {
+  aoc::arena arena;
+  return parts(parse(input, arena));
+}
+
+std::pair<long, long> parts(std::istream &input) {
+  return parts(std::string_view(slurp(input)));
+}
+
+std::pair<long, long> parts(std::istream &input,
+                            const aoc::pipeline_options &options) {
+  // ranking sorts every hand anyway, so deals can arrive in any order
+  auto unordered = options;
+  unordered.ordered = false;
+
+  aoc::arena arena;
+  Deals deals(arena.allocator());
+  aoc::pipeline(
+      input,
+      [](std::string_view line, aoc::arena &) { return parse_deal(line); },
+      [&](const Deal &deal) { deals.push_back(deal); }, unordered);
+
+  return parts(deals);
+}
+
+Leaderboard::Leaderboard(bool jokers) : jokers(jokers) {}
+
+void Leaderboard::insert(std::string_view hand, int bid) {
+  auto key = this->key(hand);
+  if (this->count_below(key + 1) != this->count_below(key)) {
+    throw std::runtime_error(std::format("hand already entered: {}", hand));
+  }
+
+  // every hand above the new one moves up a rank
+  long rank = this->count_below(key) + 1;
+  long above = this->bid_total - this->bids_below(key + 1);
+  this->total += bid * rank + above;
+
+  this->update(key, 1, bid);
+}
+
+void Leaderboard::remove(std::string_view hand) {
+  auto key = this->key(hand);
+  if (this->count_below(key + 1) == this->count_below(key)) {
+    throw std::runtime_error(std::format("hand not entered: {}", hand));
+  }
+
+  long bid = this->bids_below(key + 1) - this->bids_below(key);
+  long rank = this->count_below(key) + 1;
+  long above = this->bid_total - this->bids_below(key + 1);
+  this->total -= bid * rank + above;
+
+  this->update(key, -1, -bid);
+}
+
+std::uint32_t Leaderboard::key(std::string_view hand) const {
+  return static_cast<std::uint32_t>(this->jokers
+                                        ? parse_hand<true>(hand).key()
+                                        : parse_hand<false>(hand).key());
+}
+
+void Leaderboard::update(std::uint32_t key, int count, long bid) {
+  this->entries += count;
+  this->bid_total += bid;
+
+  for (auto i = key + 1; i <= hand_keys; i += i & -i) {
+    auto &node = this->nodes[i];
+    node.count += count;
+    node.bids += bid;
+    // no hand under it is left, so its bids are gone too
+    if (node.count == 0) {
+      this->nodes.erase(i);
+    }
+  }
+}
+
+long Leaderboard::count_below(std::uint32_t key) const {
+  long sum = 0;
+  for (auto i = key; i > 0; i -= i & -i) {
+    if (auto node = this->nodes.find(i); node != this->nodes.end()) {
+      sum += node->second.count;
+    }
+  }
+
+  return sum;
+}
+
+long Leaderboard::bids_below(std::uint32_t key) const {
+  long sum = 0;
+  for (auto i = key; i > 0; i -= i & -i) {
+    if (auto node = this->nodes.find(i); node != this->nodes.end()) {
+      sum += node->second.bids;
+    }
+  }
+
+  return sum;
+}
+} // namespace day07
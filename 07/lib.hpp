@@ -1,5 +1,103 @@
 #pragma once
+#include "../common/arena.hpp"
+#include "../common/pipeline.hpp"
+#include "hand.hpp"
+
+#include <array>
+#include <cstdint>
 #include <istream>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace day07 {
+// Keys cached answers and snapshots; see aoc::cache::key before bumping.
+inline constexpr int version = 1;
+
+// One line of input. Cards are read under the standard ruleset; part 2 turns
+// jacks into jokers when it builds its hands.
+struct Deal {
+  std::array<card_value, 5> cards;
+  int bid;
+};
+
+using Deals = std::pmr::vector<Deal>;
 
+// Parses the whole input into the arena, which must outlive the deals.
+Deals parse(std::string_view input, aoc::arena &arena);
+
+long part1(const Deals &deals);
 long part1(std::istream &input);
+long part1(std::string_view input);
+long part2(const Deals &deals);
 long part2(std::istream &input);
+long part2(std::string_view input);
+
+// Solves both parts from a single pass over the input.
+std::pair<long, long> parts(const Deals &deals);
+std::pair<long, long> parts(std::istream &input);
+std::pair<long, long> parts(std::string_view input);
+// As above, but parses lines on worker threads as the input streams in.
+std::pair<long, long> parts(std::istream &input,
+                            const aoc::pipeline_options &options);
+
+// A deal as a snapshot keeps it: the hand's packed key, which orders the same
+// way hands do, and its bid.
+struct Ranked {
+  std::uint32_t key;
+  std::int32_t bid;
+};
+
+// The deals ranked weakest first under each ruleset, so either part is a
+// single pass. The spans point into the snapshot's bytes.
+struct Rankings {
+  std::span<const Ranked> standard;
+  std::span<const Ranked> jokers;
+};
+
+// Writes the deals as a snapshot (see common/snapshot.hpp), and reads one
+// back in place, throwing if it isn't a snapshot of this version of day 07.
+std::string snapshot(const Deals &deals);
+Rankings load(std::string_view snapshot);
+
+long part1(const Rankings &rankings);
+long part2(const Rankings &rankings);
+
+// Keeps total winnings current as hands enter and leave a tournament. Hands
+// are indexed by their packed key in a Fenwick tree of counts and bids, so
+// each update is O(log n) in the key space. The tree is sparse: a node is
+// kept only while some entered hand is under it, so memory follows the hands
+// present rather than the key space.
+class Leaderboard {
+public:
+  explicit Leaderboard(bool jokers);
+
+  void insert(std::string_view hand, int bid);
+  void remove(std::string_view hand);
+
+  long winnings() const { return total; }
+  std::size_t size() const { return entries; }
+
+private:
+  std::uint32_t key(std::string_view hand) const;
+  void update(std::uint32_t key, int count, long bid);
+  long count_below(std::uint32_t key) const;
+  long bids_below(std::uint32_t key) const;
+
+  struct Node {
+    int count = 0;
+    long bids = 0;
+  };
+
+  bool jokers;
+  // by Fenwick index, which is the key plus one
+  std::unordered_map<std::uint32_t, Node> nodes;
+  long bid_total = 0;
+  long total = 0;
+  std::size_t entries = 0;
+};
+} // namespace day07
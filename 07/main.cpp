@@ -1,15 +1,30 @@
+#include "../common/cache.hpp"
+#include "../common/input.hpp"
 #include "lib.hpp"
 
-#include <fstream>
 #include <iostream>
+#include <optional>
+#include <utility>
 
 int main() {
-  std::ifstream input_file("input");
+  aoc::mapped_file input_file("input");
 
   if (input_file.is_open()) {
-    std::cout << "part1: " << part1(input_file) << std::endl;
-    input_file.clear();
-    input_file.seekg(0, std::iostream::beg);
-    std::cout << "part2: " << part2(input_file) << std::endl;
+    aoc::cache::answers answers("07", day07::version, input_file.view());
+    aoc::arena arena;
+    // both parts come out of one pass, whichever is asked for first
+    std::optional<std::pair<long, long>> parts;
+    auto solved = [&]() -> const std::pair<long, long> & {
+      if (!parts) {
+        parts = day07::parts(day07::parse(input_file.view(), arena));
+      }
+      return *parts;
+    };
+
+    std::cout << "part1: " << answers.get("1", [&] { return solved().first; })
+              << std::endl;
+    std::cout << "part2: "
+              << answers.get("2", [&] { return solved().second; })
+              << std::endl;
   }
 }
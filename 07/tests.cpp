@@ -1,7 +1,12 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "hand.hpp"
 #include "lib.hpp"
+#include "constant.hpp"
+#include "../common/alloc.hpp"
 #include <doctest/doctest.h>
 
+using namespace day07;
+
 TEST_CASE("07-part1") {
   constexpr auto input = R"FOO(
 32T3K 765
@@ -25,3 +30,217 @@ QQQJA 483
   std::stringstream ss(1 + input);
   CHECK(part2(ss) == 5905);
 }
+
+TEST_CASE("07-classification") {
+  constexpr auto input = R"FOO(
+JJJJJ 3
+JJJJ2 5
+22JJ3 7
+2345J 11
+23456 13
+AAKKQ 17
+QQQJK 19
+TTTT9 23
+)FOO";
+  std::stringstream p1(1 + input);
+  CHECK(part1(p1) == 416);
+  std::stringstream p2(1 + input);
+  CHECK(part2(p2) == 404);
+}
+
+TEST_CASE("07-parts") {
+  constexpr auto input = R"FOO(
+32T3K 765
+T55J5 684
+KK677 28
+KTJJT 220
+QQQJA 483
+)FOO";
+  std::stringstream ss(1 + input);
+  CHECK(parts(ss) == std::pair(6440L, 5905L));
+  CHECK(parts(std::string_view(1 + input)) == std::pair(6440L, 5905L));
+}
+
+TEST_CASE("07-snapshot") {
+  constexpr auto input = R"FOO(
+32T3K 765
+T55J5 684
+KK677 28
+KTJJT 220
+QQQJA 483
+)FOO";
+  aoc::arena arena;
+  auto bytes = snapshot(parse(1 + input, arena));
+  auto rankings = load(bytes);
+  REQUIRE(rankings.standard.size() == 5);
+  CHECK(rankings.standard.front().bid == 765);
+  CHECK(rankings.jokers.back().bid == 220);
+  CHECK(part1(rankings) == 6440);
+  CHECK(part2(rankings) == 5905);
+  CHECK_THROWS(load(bytes.substr(0, 40)));
+}
+
+TEST_CASE("07-constant") {
+  constexpr std::string_view example = R"FOO(32T3K 765
+T55J5 684
+KK677 28
+KTJJT 220
+QQQJA 483
+)FOO";
+  using namespace day07::constant;
+  constexpr auto deals = parse<count(example)>(example);
+  static_assert(deals.size() == 5 && deals[4].bid == 483);
+  static_assert(part1(deals) == 6440);
+  static_assert(part2(deals) == 5905);
+
+  CHECK(card('J') == card_value::jack);
+  CHECK(card('2') == card_value::two);
+  CHECK_FALSE(card('1'));
+  CHECK_THROWS(deal("32T3K"));
+  CHECK_THROWS(deal("32T1K 765"));
+  CHECK_THROWS(deal("32T3K -765"));
+}
+
+TEST_CASE("07-parse") {
+  constexpr auto input = R"FOO(
+32T3K 765
+T55J5 684
+KK677 28
+KTJJT 220
+QQQJA 483
+)FOO";
+  using enum card_value;
+  aoc::arena arena;
+  auto deals = parse(1 + input, arena);
+  REQUIRE(deals.size() == 5);
+  CHECK(deals[3].cards == std::array{king, ten, jack, jack, ten});
+  CHECK(deals[3].bid == 220);
+
+  CHECK(part1(deals) == 6440);
+  CHECK(part2(deals) == 5905);
+  CHECK(parts(deals) == std::pair(6440L, 5905L));
+}
+
+TEST_CASE("07-parts-fallback") {
+  // irregular spacing misses the fast path but still parses
+  constexpr auto input = R"FOO(
+32T3K   765
+T55J5 684
+KK677 28
+KTJJT  220
+QQQJA 483
+)FOO";
+  CHECK(parts(std::string_view(1 + input)) == std::pair(6440L, 5905L));
+  CHECK_THROWS(parts(std::string_view("32T3X 765\n")));
+
+  aoc::arena arena;
+  auto deals = parse(1 + input, arena);
+  REQUIRE(deals.size() == 5);
+  CHECK(deals[0].bid == 765);
+  CHECK(deals[3].bid == 220);
+}
+
+TEST_CASE("07-pipeline") {
+  constexpr auto input = R"FOO(
+32T3K 765
+T55J5 684
+KK677 28
+KTJJT 220
+QQQJA 483
+)FOO";
+  aoc::pipeline_options options{.block_size = 16, .depth = 2, .workers = 3};
+  std::stringstream ss(1 + input);
+  CHECK(parts(ss, options) == std::pair(6440L, 5905L));
+
+  // a bad line on a worker thread surfaces on the caller
+  std::stringstream bad("32T3K 765\n32T3X 765\nKK677 28\n");
+  CHECK_THROWS(parts(bad, options));
+}
+
+TEST_CASE("07-leaderboard") {
+  Leaderboard standard(false), jokers(true);
+  for (auto [hand, bid] : {std::pair("32T3K", 765), std::pair("T55J5", 684),
+                           std::pair("KK677", 28), std::pair("KTJJT", 220),
+                           std::pair("QQQJA", 483)}) {
+    standard.insert(hand, bid);
+    jokers.insert(hand, bid);
+  }
+
+  CHECK(standard.winnings() == 6440);
+  CHECK(jokers.winnings() == 5905);
+
+  standard.remove("KK677");
+  jokers.remove("KK677");
+  CHECK(standard.size() == 4);
+  CHECK(standard.winnings() == 5189);
+  CHECK(jokers.winnings() == 4462);
+
+  CHECK_THROWS(standard.insert("32T3K", 1));
+  CHECK_THROWS(standard.remove("KK677"));
+
+  // emptied and refilled, the sparse tree still ranks correctly
+  for (auto hand : {"32T3K", "T55J5", "KTJJT", "QQQJA"}) {
+    standard.remove(hand);
+  }
+  CHECK(standard.size() == 0);
+  CHECK(standard.winnings() == 0);
+  standard.insert("KK677", 28);
+  standard.insert("32T3K", 765);
+  CHECK(standard.winnings() == 765 + 2 * 28);
+}
+
+TEST_CASE("07-generic-hands") {
+  using enum card_value;
+
+  // the generic signatures order five card hands like the lookup tables
+  std::array<std::array<card_value, 5>, 7> ranked{{
+      {two, three, four, five, six},
+      {two, two, four, five, six},
+      {two, two, four, four, six},
+      {two, two, two, five, six},
+      {two, two, two, six, six},
+      {two, two, two, two, six},
+      {two, two, two, two, two},
+  }};
+  for (std::size_t i = 1; i < ranked.size(); ++i) {
+    CHECK(generic_classifier<5>::classify(ranked[i - 1]) <
+          generic_classifier<5>::classify(ranked[i]));
+    CHECK(classifier<5>::classify(ranked[i - 1]) <
+          classifier<5>::classify(ranked[i]));
+  }
+
+  CHECK(BasicHand<3>({ace, king, queen}) < BasicHand<3>({two, two, three}));
+  CHECK(BasicHand<3>({two, two, three}) < BasicHand<3>({two, two, four}));
+  CHECK(BasicHand<3, joker>({ace, king, queen}) <
+        BasicHand<3, joker>({joker, two, three}));
+
+  // twos and jokers both wild: four of a kind beats three pairs
+  CHECK(BasicHand<7, joker, two>({ace, ace, king, king, queen, queen, jack}) <
+        BasicHand<7, joker, two>({ace, two, joker, ten, nine, three, four}));
+}
+
+#ifdef AOC_TRACK_ALLOC
+// The structural index, and the hands the solver ranks; the deals stay in the
+// arena.
+TEST_CASE("07-allocations") {
+  constexpr auto example = R"FOO(
+32T3K 765
+T55J5 684
+KK677 28
+KTJJT 220
+QQQJA 483
+)FOO";
+  REQUIRE(aoc::alloc::tracking());
+  auto input = std::string_view(1 + example);
+
+  auto [part1_answer, part1_used] =
+      aoc::alloc::measure([&] { return part1(input); });
+  CHECK(part1_answer == 6440);
+  CHECK(aoc::alloc::within(part1_used, {.count = 12, .peak = 512}));
+
+  auto [part2_answer, part2_used] =
+      aoc::alloc::measure([&] { return part2(input); });
+  CHECK(part2_answer == 5905);
+  CHECK(aoc::alloc::within(part2_used, {.count = 12, .peak = 512}));
+}
+#endif
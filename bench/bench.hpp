@@ -0,0 +1,69 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+struct Options {
+  int warmup = 3;
+  int reps = 15;
+};
+
+struct Result {
+  std::string name;
+  std::size_t bytes;
+  std::size_t records;
+  std::vector<double> samples; // nanoseconds, sorted
+};
+
+// Keeps the compiler from discarding a result nobody reads.
+template <typename T> void keep(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename F>
+Result measure(std::string name, const Options &options, std::size_t bytes,
+               std::size_t records, F &&f) {
+  for (int i = 0; i < options.warmup; ++i) {
+    keep(f());
+  }
+
+  Result result{std::move(name), bytes, records, {}};
+  result.samples.reserve(options.reps);
+  for (int i = 0; i < options.reps; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    keep(f());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    result.samples.push_back(
+        std::chrono::duration<double, std::nano>(elapsed).count());
+  }
+
+  std::ranges::sort(result.samples);
+  return result;
+}
+
+// Nearest-rank percentile of the sorted samples.
+inline double percentile(const Result &result, double p) {
+  auto rank = static_cast<std::size_t>(p / 100 * result.samples.size());
+  return result.samples[std::min(rank, result.samples.size() - 1)];
+}
+
+// Writes one JSON object per line so runs can be diffed or loaded as JSONL.
+inline void report(std::ostream &out, const Result &result) {
+  double median = percentile(result, 50);
+  out << "{\"name\":\"" << result.name << "\",\"bytes\":" << result.bytes
+      << ",\"records\":" << result.records
+      << ",\"reps\":" << result.samples.size()
+      << ",\"min_ns\":" << result.samples.front()
+      << ",\"median_ns\":" << median << ",\"p90_ns\":" << percentile(result, 90)
+      << ",\"p99_ns\":" << percentile(result, 99)
+      << ",\"max_ns\":" << result.samples.back()
+      << ",\"bytes_per_sec\":" << result.bytes / median * 1e9
+      << ",\"records_per_sec\":" << result.records / median * 1e9 << "}"
+      << std::endl;
+}
+} // namespace bench
@@ -0,0 +1,196 @@
+#include "../01/calibration.hpp"
+#include "../02/lib.hpp"
+#include "../03/lib.hpp"
+#include "../04/lib.hpp"
+#include "../05/lib.hpp"
+#include "../06/lib.hpp"
+#include "../07/lib.hpp"
+#include "../common/integer.hpp"
+#include "../common/structural.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifndef AOC_SOURCE_DIR
+#define AOC_SOURCE_DIR "."
+#endif
+
+namespace {
+struct Input {
+  std::string text;
+  std::size_t records;
+};
+
+Input load(const std::string &path, int scale) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("could not open " + path);
+  }
+
+  auto it = std::istreambuf_iterator(file);
+  std::string once(it, {});
+  if (!once.empty() && once.back() != '\n') {
+    once.push_back('\n');
+  }
+
+  std::string text;
+  text.reserve(once.size() * scale);
+  for (int i = 0; i < scale; ++i) {
+    text += once;
+  }
+
+  return {text, static_cast<std::size_t>(std::ranges::count(text, '\n'))};
+}
+
+void usage() {
+  std::cerr << "usage: bench [--warmup N] [--reps N] [--scale N] [--root DIR]\n"
+               "             [--input DAY=PATH] [--filter NAME]\n"
+               "\n"
+               "Times each day's entry points and prints one JSON object per\n"
+               "line. --scale repeats line-oriented inputs (01, 04, 07) N\n"
+               "times; use --input to point a day at a larger file from gen.\n";
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  bench::Options options;
+  std::string root = AOC_SOURCE_DIR;
+  std::string filter;
+  int scale = 1;
+  std::map<std::string, std::string> paths;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+
+    std::string value = argv[++i];
+    if (arg == "--warmup") {
+      options.warmup = std::stoi(value);
+    } else if (arg == "--reps") {
+      options.reps = std::stoi(value);
+    } else if (arg == "--scale") {
+      scale = std::stoi(value);
+    } else if (arg == "--root") {
+      root = value;
+    } else if (arg == "--filter") {
+      filter = value;
+    } else if (arg == "--input" && value.find('=') != std::string::npos) {
+      auto eq = value.find('=');
+      paths[value.substr(0, eq)] = value.substr(eq + 1);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  // 01, 02 and 03 keep their input with their part 1 main
+  auto input = [&](const std::string &day, bool lines,
+                   const std::string &dir = {}) {
+    auto path = paths.contains(day)
+                    ? paths[day]
+                    : root + "/" + (dir.empty() ? day : dir) + "/input";
+    return load(path, lines ? scale : 1);
+  };
+
+  auto run = [&](const std::string &name, const Input &in, auto &&solve) {
+    if (name.find(filter) == std::string::npos) {
+      return;
+    }
+
+    auto result =
+        bench::measure(name, options, in.text.size(), in.records,
+                       [&] { return solve(std::string_view(in.text)); });
+    bench::report(std::cout, result);
+  };
+
+  auto in01 = input("01", true, "01-p1");
+  run("01/part1", in01, [](auto in) { return day01::part1(in); });
+  run("01/part2", in01, [](auto in) { return day01::part2(in); });
+
+  auto in02 = input("02", true, "02-p1");
+  run("02/parse", in02, [](auto in) {
+    aoc::arena arena;
+    return day02::parse(in, arena).size();
+  });
+  run("02/part1", in02, [](auto in) { return day02::part1(in); });
+  run("02/part2", in02, [](auto in) { return day02::part2(in); });
+
+  auto in03 = input("03", false, "03-p1");
+  run("03/parse", in03, [](auto in) { return day03::parse(in).height(); });
+  run("03/part1", in03,
+      [](auto in) { return day03::part1(day03::parse(in)); });
+  run("03/part2", in03,
+      [](auto in) { return day03::part2(day03::parse(in)); });
+  run("03/sparse1", in03,
+      [](auto in) { return day03::part1(day03::parse_sparse(in)); });
+  run("03/sparse2", in03,
+      [](auto in) { return day03::part2(day03::parse_sparse(in)); });
+
+  auto in04 = input("04", true);
+  run("04/index", in04, [](auto in) {
+    return aoc::structural_index(in).structurals().size();
+  });
+  run("04/parse", in04, [](auto in) {
+    aoc::arena arena;
+    return day04::parse(in, arena).size();
+  });
+  run("04/part1", in04, [](auto in) { return day04::part1(in); });
+  run("04/part2", in04, [](auto in) { return day04::part2(in); });
+  run("04/part2_cooler", in04,
+      [](auto in) { return day04::part2_cooler(in); });
+
+  // integer conversion alone, over every number in the day 04 input
+  auto numbers = [](std::string_view in, auto convert) {
+    long sum = 0;
+    for (std::size_t at = 0; at < in.size();) {
+      auto end = in.find_first_not_of("0123456789", at);
+      end = end == std::string_view::npos ? in.size() : end;
+      if (end == at) {
+        ++at;
+        continue;
+      }
+
+      sum += convert(in.substr(at, end - at));
+      at = end;
+    }
+    return sum;
+  };
+  run("int/stol", in04, [&](auto in) {
+    return numbers(in, [](auto n) { return std::stol(std::string(n)); });
+  });
+  run("int/from_chars", in04, [&](auto in) {
+    return numbers(in, [](auto n) {
+      long value = 0;
+      std::from_chars(n.data(), n.data() + n.size(), value);
+      return value;
+    });
+  });
+  run("int/swar", in04, [&](auto in) {
+    return numbers(in, [](auto n) { return *aoc::integer::parse<long>(n); });
+  });
+
+  auto in05 = input("05", false);
+  run("05/part1", in05, [](auto in) { return day05::part1(in); });
+  run("05/part2", in05, [](auto in) { return day05::part2(in); });
+
+  auto in06 = input("06", false);
+  run("06/part1", in06, [](auto in) { return day06::part1(in); });
+  run("06/part2", in06, [](auto in) { return day06::part2(in); });
+
+  auto in07 = input("07", true);
+  run("07/part1", in07, [](auto in) { return day07::part1(in); });
+  run("07/part2", in07, [](auto in) { return day07::part2(in); });
+  run("07/parts", in07, [](auto in) { return day07::parts(in); });
+}
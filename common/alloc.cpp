@@ -0,0 +1,146 @@
+#include "alloc.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> allocations = 0;
+std::atomic<std::uint64_t> allocated = 0;
+std::atomic<std::uint64_t> live_bytes = 0;
+std::atomic<std::uint64_t> peak_bytes = 0;
+
+// Each block carries its size just before the returned pointer, so unsized
+// deletes can still be accounted for.
+constexpr std::size_t header = alignof(std::max_align_t);
+
+std::size_t offset(std::size_t align) { return std::max(header, align); }
+
+void *allocate(std::size_t size, std::size_t align) {
+  auto front = offset(align);
+  void *base;
+  if (align > header) {
+    auto total = (front + size + align - 1) / align * align;
+    base = std::aligned_alloc(align, total);
+  } else {
+    base = std::malloc(front + size);
+  }
+
+  if (base == nullptr) {
+    return nullptr;
+  }
+
+  auto *block = static_cast<std::byte *>(base) + front;
+  reinterpret_cast<std::size_t *>(block)[-1] = size;
+
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated.fetch_add(size, std::memory_order_relaxed);
+  auto now = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  auto high = peak_bytes.load(std::memory_order_relaxed);
+  while (now > high && !peak_bytes.compare_exchange_weak(
+                           high, now, std::memory_order_relaxed)) {
+  }
+
+  return block;
+}
+
+void *allocate_or_throw(std::size_t size, std::size_t align) {
+  while (true) {
+    if (auto *block = allocate(size, align)) {
+      return block;
+    }
+
+    auto handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void release(void *block, std::size_t align) {
+  if (block == nullptr) {
+    return;
+  }
+
+  auto *bytes = static_cast<std::byte *>(block);
+  auto size = reinterpret_cast<std::size_t *>(bytes)[-1];
+  live_bytes.fetch_sub(size, std::memory_order_relaxed);
+  std::free(bytes - offset(align));
+}
+} // namespace
+
+namespace aoc::alloc {
+bool tracking() { return true; }
+std::uint64_t count() { return allocations.load(std::memory_order_relaxed); }
+std::uint64_t bytes() { return allocated.load(std::memory_order_relaxed); }
+std::uint64_t live() { return live_bytes.load(std::memory_order_relaxed); }
+std::uint64_t peak() { return peak_bytes.load(std::memory_order_relaxed); }
+void set_peak(std::uint64_t value) {
+  peak_bytes.store(value, std::memory_order_relaxed);
+}
+} // namespace aoc::alloc
+
+void *operator new(std::size_t size) { return allocate_or_throw(size, 0); }
+void *operator new[](std::size_t size) { return allocate_or_throw(size, 0); }
+
+void *operator new(std::size_t size, std::align_val_t align) {
+  return allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+void *operator new[](std::size_t size, std::align_val_t align) {
+  return allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size, 0);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+  return allocate(size, static_cast<std::size_t>(align));
+}
+void *operator new[](std::size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  return allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void *block) noexcept { release(block, 0); }
+void operator delete[](void *block) noexcept { release(block, 0); }
+void operator delete(void *block, std::size_t) noexcept { release(block, 0); }
+void operator delete[](void *block, std::size_t) noexcept {
+  release(block, 0);
+}
+
+void operator delete(void *block, std::align_val_t align) noexcept {
+  release(block, static_cast<std::size_t>(align));
+}
+void operator delete[](void *block, std::align_val_t align) noexcept {
+  release(block, static_cast<std::size_t>(align));
+}
+void operator delete(void *block, std::size_t,
+                     std::align_val_t align) noexcept {
+  release(block, static_cast<std::size_t>(align));
+}
+void operator delete[](void *block, std::size_t,
+                       std::align_val_t align) noexcept {
+  release(block, static_cast<std::size_t>(align));
+}
+
+void operator delete(void *block, const std::nothrow_t &) noexcept {
+  release(block, 0);
+}
+void operator delete[](void *block, const std::nothrow_t &) noexcept {
+  release(block, 0);
+}
+void operator delete(void *block, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  release(block, static_cast<std::size_t>(align));
+}
+void operator delete[](void *block, std::align_val_t align,
+                       const std::nothrow_t &) noexcept {
+  release(block, static_cast<std::size_t>(align));
+}
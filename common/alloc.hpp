@@ -0,0 +1,103 @@
+#pragma once
+
+// Allocation tracking for solvers. Configuring with -DAOC_TRACK_ALLOC=ON links
+// common/alloc.cpp, which replaces the global operator new and delete with
+// counting versions. Without it tracking() is false and every count is zero.
+//
+//   aoc::alloc::phase p;
+//   solve(input);
+//   auto used = p.stats(); // allocations, bytes, peak live bytes
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <sys/resource.h>
+
+namespace aoc::alloc {
+struct stats {
+  std::uint64_t count = 0;
+  std::uint64_t bytes = 0;
+  // highest live byte count reached, relative to where the phase started
+  std::uint64_t peak = 0;
+};
+
+#ifdef AOC_TRACK_ALLOC
+bool tracking();
+// allocations and bytes since startup, and bytes currently live
+std::uint64_t count();
+std::uint64_t bytes();
+std::uint64_t live();
+// The high-water mark of live bytes. A phase resets it on entry and folds its
+// own peak back in on exit, so phases nest.
+std::uint64_t peak();
+void set_peak(std::uint64_t value);
+#else
+inline bool tracking() { return false; }
+inline std::uint64_t count() { return 0; }
+inline std::uint64_t bytes() { return 0; }
+inline std::uint64_t live() { return 0; }
+inline std::uint64_t peak() { return 0; }
+inline void set_peak(std::uint64_t) {}
+#endif
+
+// Counts allocations from every thread while it is alive.
+class phase {
+public:
+  phase()
+      : outer_peak(peak()), start_count(count()), start_bytes(bytes()),
+        start_live(live()) {
+    set_peak(start_live);
+  }
+
+  ~phase() {
+    auto inner = peak();
+    set_peak(inner > outer_peak ? inner : outer_peak);
+  }
+
+  phase(const phase &) = delete;
+  phase &operator=(const phase &) = delete;
+
+  alloc::stats stats() const {
+    auto high = peak();
+    return {count() - start_count, bytes() - start_bytes,
+            high > start_live ? high - start_live : 0};
+  }
+
+private:
+  std::uint64_t outer_peak, start_count, start_bytes, start_live;
+};
+
+// What a solver may allocate on a fixed input, for tests to hold it to. A
+// budget is a ceiling rather than an exact count: about twice what a tracked
+// run uses, which leaves room for another standard library's container growth
+// and string sizes. Where the arena absorbs everything, the budget is zero.
+//
+//   auto [answer, used] = aoc::alloc::measure([&] { return part1(input); });
+//   CHECK(aoc::alloc::within(used, {.count = 12, .peak = 2048}));
+struct budget {
+  std::uint64_t count = 0;
+  std::uint64_t peak = 0;
+};
+
+inline bool within(const alloc::stats &used, const budget &limit) {
+  return used.count <= limit.count && used.peak <= limit.peak;
+}
+
+// Calls solve in a phase of its own, returning its answer and allocations.
+template <typename Solve> auto measure(Solve &&solve) {
+  phase p;
+  auto answer = solve();
+  return std::pair{std::move(answer), p.stats()};
+}
+
+// Peak resident set size of the process, in bytes, tracked or not.
+inline std::uint64_t peak_rss() {
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  // Linux reports kilobytes
+  return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+}
+} // namespace aoc::alloc
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+namespace aoc {
+// A monotonic arena for parse results. Allocations are carved from a small
+// inline buffer first, then from upstream blocks that grow geometrically, and
+// are all freed together by release() or the destructor.
+//
+// The allocator doubles as the lexy parse state, so a grammar opts in with
+// lexy::as_list<std::pmr::vector<T>>.allocator() (or as_collection, as_string)
+// and is parsed with lexy::parse<P>(input, arena.allocator(), handler).
+//
+// Copying a pmr container falls back to the default resource, so move parse
+// results out of the arena rather than copying them.
+class arena {
+public:
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
+  arena() : resource(buffer.data(), buffer.size()), alloc(&resource) {}
+
+  arena(const arena &) = delete;
+  arena &operator=(const arena &) = delete;
+
+  const allocator_type &allocator() const { return alloc; }
+
+  // Everything allocated so far becomes invalid; the inline buffer is reused.
+  void release() { resource.release(); }
+
+private:
+  alignas(std::max_align_t) std::array<std::byte, 4096> buffer;
+  std::pmr::monotonic_buffer_resource resource;
+  allocator_type alloc;
+};
+} // namespace aoc
@@ -0,0 +1,211 @@
+#include "cache.hpp"
+#include "integer.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace aoc::cache {
+namespace {
+constexpr std::array<std::uint64_t, 4> keys = {
+    0xa0761d6478bd642f, 0xe7037ed1a0b428db, 0x8ebc6af09c88c6e3,
+    0x589965cc75374cc3};
+
+// Folds the 128 bit product of a and b into 64 bits.
+std::uint64_t mix(std::uint64_t a, std::uint64_t b) {
+  auto product = static_cast<unsigned __int128>(a) * b;
+  return static_cast<std::uint64_t>(product) ^
+         static_cast<std::uint64_t>(product >> 64);
+}
+
+std::uint64_t load(const char *in) {
+  std::uint64_t word;
+  std::memcpy(&word, in, sizeof(word));
+  return word;
+}
+
+// The first line of an entry, which has to match for the entry to count.
+std::string describe(const key &key) {
+  return std::string(key.day) + ' ' + std::string(key.part) + ' ' +
+         std::to_string(key.version) + ' ' + std::to_string(key.size) + ' ' +
+         std::to_string(key.input);
+}
+
+std::string file_name(std::string_view described) {
+  constexpr std::string_view digits = "0123456789abcdef";
+  auto value = hash(described);
+  std::string name(16, '0');
+  for (int i = 15; i >= 0; --i, value >>= 4) {
+    name[i] = digits[value & 0xF];
+  }
+  return name;
+}
+
+bool temporary(const std::filesystem::path &path) {
+  return path.filename().string().find(".tmp.") != std::string::npos;
+}
+} // namespace
+
+std::uint64_t hash(std::string_view bytes, std::uint64_t seed) {
+  constexpr std::size_t block = 64;
+  std::array<std::uint64_t, 4> lanes;
+  for (std::size_t i = 0; i < lanes.size(); ++i) {
+    lanes[i] = seed ^ keys[i];
+  }
+
+  // each lane takes 16 bytes of every block, with no dependency between
+  // lanes for the multiplies to wait on
+  auto round = [&lanes](const char *in) {
+    for (std::size_t i = 0; i < lanes.size(); ++i) {
+      auto low = load(in + 16 * i) ^ keys[i];
+      auto high = load(in + 16 * i + 8) ^ lanes[i];
+      lanes[i] = mix(low, high);
+    }
+  };
+
+  std::size_t at = 0;
+  for (; at + block <= bytes.size(); at += block) {
+    round(bytes.data() + at);
+  }
+  if (at < bytes.size()) {
+    std::array<char, block> tail{};
+    std::memcpy(tail.data(), bytes.data() + at, bytes.size() - at);
+    round(tail.data());
+  }
+
+  // the length tells apart inputs that differ only in trailing zeros
+  std::uint64_t out = mix(seed ^ keys[0], bytes.size() ^ keys[1]);
+  for (std::size_t i = 0; i < lanes.size(); ++i) {
+    out = mix(out ^ lanes[i], keys[i]);
+  }
+  return mix(out, keys[0] ^ keys[3]);
+}
+
+store::store(std::filesystem::path dir, std::uintmax_t limit)
+    : dir(std::move(dir)), limit(limit) {
+  std::filesystem::create_directories(this->dir);
+}
+
+std::optional<store> store::from_env() {
+  const char *dir = std::getenv("AOC_CACHE");
+  if (dir == nullptr || *dir == '\0') {
+    return std::nullopt;
+  }
+  try {
+    return store(dir);
+  } catch (const std::filesystem::filesystem_error &) {
+    // an unusable cache only costs the time it would have saved
+    return std::nullopt;
+  }
+}
+
+std::optional<long> store::get(const key &key) const {
+  auto described = describe(key);
+  auto path = this->dir / file_name(described);
+  std::ifstream entry(path);
+  std::string header, answer;
+  if (!std::getline(entry, header) || !std::getline(entry, answer) ||
+      header != described) {
+    return std::nullopt;
+  }
+
+  auto value = aoc::integer::parse<long>(answer);
+  if (value) {
+    // eviction goes by modification time, so a hit counts as a use
+    std::error_code ignored;
+    std::filesystem::last_write_time(
+        path, std::filesystem::file_time_type::clock::now(), ignored);
+  }
+  return value;
+}
+
+void store::put(const key &key, long answer) const {
+  static std::atomic<unsigned> written = 0;
+  auto described = describe(key);
+  auto name = file_name(described);
+  auto path = this->dir / name;
+  auto staged = this->dir / (name + ".tmp." + std::to_string(::getpid()) +
+                             "." + std::to_string(written++));
+
+  {
+    std::ofstream entry(staged, std::ios::trunc);
+    entry << described << '\n' << answer << '\n';
+    if (!entry.flush()) {
+      std::error_code ignored;
+      std::filesystem::remove(staged, ignored);
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(staged, path, error);
+  if (error) {
+    std::filesystem::remove(staged, error);
+    return;
+  }
+
+  // a full scan of the directory on every write would cost more than most
+  // solves, so only about one write in sixteen checks the size
+  if ((hash(name) & 15) == 0) {
+    this->evict();
+  }
+}
+
+// Removes the least recently used entries until they take up three quarters
+// of the limit, along with temporaries that crashed writers left behind.
+void store::evict() const {
+  namespace fs = std::filesystem;
+  struct entry {
+    fs::path path;
+    fs::file_time_type used;
+    std::uintmax_t size;
+  };
+
+  std::error_code error;
+  auto stale = fs::file_time_type::clock::now() - std::chrono::minutes(10);
+  std::vector<entry> entries;
+  std::uintmax_t total = 0;
+  for (const auto &file : fs::directory_iterator(this->dir, error)) {
+    std::error_code missing;
+    auto used = file.last_write_time(missing);
+    auto size = missing ? 0 : file.file_size(missing);
+    if (missing) {
+      // removed by another process since the listing
+      continue;
+    }
+
+    if (temporary(file.path())) {
+      if (used < stale) {
+        fs::remove(file.path(), error);
+      }
+      continue;
+    }
+
+    entries.push_back({file.path(), used, size});
+    total += size;
+  }
+
+  if (total <= this->limit) {
+    return;
+  }
+
+  std::ranges::sort(entries, {}, &entry::used);
+  for (const auto &old : entries) {
+    if (total <= this->limit / 4 * 3) {
+      break;
+    }
+    if (fs::remove(old.path, error)) {
+      total -= old.size;
+    }
+  }
+}
+} // namespace aoc::cache
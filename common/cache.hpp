@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+// Answers kept on disk, so an input that has been solved before costs one
+// hash over it and a file lookup instead of a parse and a solve. The days'
+// mains ask answers first and only parse when a part misses, so with AOC_CACHE
+// set a repeated input isn't parsed again.
+//
+//   auto cache = aoc::cache::store::from_env();
+//   aoc::cache::key key{"04", "1", day04::version, aoc::cache::hash(input),
+//                       input.size()};
+//   if (auto answer = cache ? cache->get(key) : std::nullopt) { ... }
+namespace aoc::cache {
+// A 64 bit hash of the bytes, in four independent lanes of 128 bit
+// multiplies so it runs at several bytes per cycle. Not cryptographic.
+std::uint64_t hash(std::string_view bytes, std::uint64_t seed = 0);
+
+// What an answer depends on: the solver, and the input by hash and length.
+//
+// The solver is its day, part and version. Each day's lib.hpp has a version
+// constant, and nothing else invalidates an entry, so it must be bumped with
+// any change to the day that could alter an answer; entries under the old
+// version are never read again and age out of the store. Days with snapshots
+// stamp the same version on them, so a bump refuses their old snapshots too.
+struct key {
+  std::string_view day;
+  std::string_view part;
+  int version = 0;
+  std::uint64_t input = 0;
+  std::size_t size = 0;
+};
+
+// One file per answer in a directory. Entries are written to a temporary
+// file and renamed into place, so readers, including other processes, never
+// see half of one. Once the entries outgrow the limit the least recently
+// used are removed.
+class store {
+public:
+  static constexpr std::uintmax_t default_limit = 4 << 20;
+
+  explicit store(std::filesystem::path dir,
+                 std::uintmax_t limit = default_limit);
+
+  // The store in the directory named by AOC_CACHE, or nothing when it is
+  // unset or empty.
+  static std::optional<store> from_env();
+
+  std::optional<long> get(const key &key) const;
+  // Failing to write is not an error; the answer just isn't cached.
+  void put(const key &key, long answer) const;
+
+  const std::filesystem::path &directory() const { return dir; }
+
+private:
+  void evict() const;
+
+  std::filesystem::path dir;
+  std::uintmax_t limit;
+};
+
+// The answers for one input, from the AOC_CACHE store where it has them.
+// The input is hashed once, up front, and only when there is a store.
+//
+//   aoc::cache::answers answers("06", day06::version, input);
+//   auto p1 = answers.get("1", [&] { return day06::part1(races()); });
+class answers {
+public:
+  answers(std::string_view day, int version, std::string_view input)
+      : cache(store::from_env()), day(day), version(version),
+        size(input.size()) {
+    if (this->cache) {
+      this->input = hash(input);
+    }
+  }
+
+  // The cached answer for part, or what solve returns, which is then cached.
+  template <typename F> long get(std::string_view part, F &&solve) const {
+    key key{this->day, part, this->version, this->input, this->size};
+    if (this->cache) {
+      if (auto answer = this->cache->get(key)) {
+        return *answer;
+      }
+    }
+
+    long answer = solve();
+    if (this->cache) {
+      this->cache->put(key, answer);
+    }
+    return answer;
+  }
+
+private:
+  std::optional<store> cache;
+  std::string_view day;
+  int version;
+  std::uint64_t input = 0;
+  std::size_t size;
+};
+} // namespace aoc::cache
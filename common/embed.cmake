@@ -0,0 +1,33 @@
+# Writes the bytes of INPUT to OUTPUT as a header declaring them as
+# aoc::embedded::NAME, a constexpr std::string_view, so solvers can read the
+# file in constant expressions. Run as a script:
+#
+#   cmake -DINPUT=06/input -DOUTPUT=day06.hpp -DNAME=day06 -P embed.cmake
+file(READ "${INPUT}" hex HEX)
+string(LENGTH "${hex}" digits)
+math(EXPR size "${digits} / 2")
+
+# sixteen bytes of \x escapes to a line; every byte is escaped, so no escape
+# runs into the text after it
+set(literal "")
+set(at 0)
+while(at LESS digits)
+  string(SUBSTRING "${hex}" ${at} 32 chunk)
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "\\\\x\\1" chunk "${chunk}")
+  string(APPEND literal "\n    \"${chunk}\"")
+  math(EXPR at "${at} + 32")
+endwhile()
+if(size EQUAL 0)
+  set(literal " \"\"")
+endif()
+
+file(WRITE "${OUTPUT}.tmp" "// Generated from ${INPUT} by common/embed.cmake.
+#pragma once
+#include <string_view>
+
+namespace aoc::embedded {
+inline constexpr std::string_view ${NAME}{${literal},
+    ${size}};
+} // namespace aoc::embedded
+")
+file(RENAME "${OUTPUT}.tmp" "${OUTPUT}")
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace aoc {
+// A width x height grid ringed by a halo of border cells, so any cell's eight
+// neighbours can be read without checking for an edge: cell(x, y) is valid
+// for x in [-1, width] and y in [-1, height].
+//
+// Rows are stored one stride apart, with every row starting on a 64 byte
+// boundary. The padding after each row is border, and doubles as the left
+// halo of the next one:
+//
+//   aoc::grid<char> g(width, height, '.');
+//   std::ranges::copy(line, g.row(y).begin());
+//   for (auto offset : g.neighbours()) { use(g.data(x, y)[offset]); }
+template <typename T> class grid {
+  static_assert(std::is_trivially_copyable_v<T> &&
+                std::is_trivially_destructible_v<T>);
+
+public:
+  static constexpr std::size_t alignment = 64;
+  // cells per aligned block, which rows are padded to a multiple of
+  static constexpr std::size_t lanes = std::max<std::size_t>(
+      1, alignment / sizeof(T));
+
+  grid(std::size_t width, std::size_t height, T border = T{})
+      : w(width), h(height),
+        step((width + 1 + lanes - 1) / lanes * lanes),
+        cells(allocate(lanes + (height + 2) * step)),
+        origin(cells.get() + lanes + step),
+        offsets{-static_cast<std::ptrdiff_t>(step) - 1,
+                -static_cast<std::ptrdiff_t>(step),
+                -static_cast<std::ptrdiff_t>(step) + 1,
+                -1,
+                1,
+                static_cast<std::ptrdiff_t>(step) - 1,
+                static_cast<std::ptrdiff_t>(step),
+                static_cast<std::ptrdiff_t>(step) + 1} {
+    std::fill_n(cells.get(), lanes + (height + 2) * step, border);
+  }
+
+  std::size_t width() const { return w; }
+  std::size_t height() const { return h; }
+  // Cells from the start of one row to the start of the next.
+  std::size_t stride() const { return step; }
+
+  T *data(std::ptrdiff_t x, std::ptrdiff_t y) {
+    return origin + y * static_cast<std::ptrdiff_t>(step) + x;
+  }
+  const T *data(std::ptrdiff_t x, std::ptrdiff_t y) const {
+    return origin + y * static_cast<std::ptrdiff_t>(step) + x;
+  }
+
+  T &cell(std::ptrdiff_t x, std::ptrdiff_t y) { return *data(x, y); }
+  const T &cell(std::ptrdiff_t x, std::ptrdiff_t y) const {
+    return *data(x, y);
+  }
+
+  // The width cells of row y, which may also be a halo row.
+  std::span<T> row(std::ptrdiff_t y) { return {data(0, y), w}; }
+  std::span<const T> row(std::ptrdiff_t y) const { return {data(0, y), w}; }
+
+  // count cells of row y from x on, which may reach into the halo on either
+  // side: -1 <= x and x + count <= width + 1.
+  std::span<T> run(std::ptrdiff_t x, std::ptrdiff_t y, std::size_t count) {
+    return {data(x, y), count};
+  }
+  std::span<const T> run(std::ptrdiff_t x, std::ptrdiff_t y,
+                         std::size_t count) const {
+    return {data(x, y), count};
+  }
+
+  // Offsets from a cell's address to its eight neighbours', row by row from
+  // the top left.
+  const std::array<std::ptrdiff_t, 8> &neighbours() const { return offsets; }
+
+  // The coordinates of a cell from its address.
+  std::pair<std::ptrdiff_t, std::ptrdiff_t> position(const T *at) const {
+    // offset from (-1, -1), so both divisions work on non-negative values
+    auto from = static_cast<std::size_t>(at - data(-1, -1));
+    return {static_cast<std::ptrdiff_t>(from % step) - 1,
+            static_cast<std::ptrdiff_t>(from / step) - 1};
+  }
+
+private:
+  struct release {
+    void operator()(T *cells) const {
+      ::operator delete(cells, std::align_val_t(alignment));
+    }
+  };
+
+  static std::unique_ptr<T[], release> allocate(std::size_t count) {
+    return std::unique_ptr<T[], release>(static_cast<T *>(
+        ::operator new(count * sizeof(T), std::align_val_t(alignment))));
+  }
+
+  std::size_t w;
+  std::size_t h;
+  std::size_t step;
+  std::unique_ptr<T[], release> cells;
+  T *origin;
+  std::array<std::ptrdiff_t, 8> offsets;
+};
+} // namespace aoc
@@ -0,0 +1,47 @@
+#include "input.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aoc {
+mapped_file::mapped_file(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    return;
+  }
+
+  this->size = static_cast<std::size_t>(st.st_size);
+  this->open = true;
+
+  // mmap rejects empty mappings; an empty file is just an empty view
+  if (this->size > 0) {
+    void *addr = ::mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      this->size = 0;
+      this->open = false;
+    } else {
+      ::madvise(addr, this->size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+      ::madvise(addr, this->size, MADV_HUGEPAGE);
+#endif
+      this->data = static_cast<const char *>(addr);
+    }
+  }
+
+  ::close(fd);
+}
+
+mapped_file::~mapped_file() {
+  if (this->data != nullptr) {
+    ::munmap(const_cast<char *>(this->data), this->size);
+  }
+}
+} // namespace aoc
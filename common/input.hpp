@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace aoc {
+// Splits a buffer into lines lazily, without copying. Like std::getline, a
+// trailing newline does not produce an empty last line. Usable in constant
+// expressions.
+class lines {
+public:
+  class iterator {
+  public:
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+
+    constexpr iterator() = default;
+    constexpr explicit iterator(std::string_view rest) : rest(rest) {
+      ++*this;
+    }
+
+    constexpr std::string_view operator*() const { return line; }
+
+    constexpr iterator &operator++() {
+      if (rest.data() == nullptr) {
+        done = true;
+        return *this;
+      }
+
+      auto end = rest.find('\n');
+      line = rest.substr(0, end);
+      rest = end == std::string_view::npos || end + 1 == rest.size()
+                 ? std::string_view()
+                 : rest.substr(end + 1);
+      return *this;
+    }
+
+    constexpr void operator++(int) { ++*this; }
+
+    constexpr bool operator==(std::default_sentinel_t) const { return done; }
+
+  private:
+    std::string_view rest;
+    std::string_view line;
+    bool done = false;
+  };
+
+  constexpr explicit lines(std::string_view buffer)
+      : buffer(buffer.empty() ? std::string_view() : buffer) {}
+
+  constexpr iterator begin() const { return iterator(buffer); }
+  constexpr std::default_sentinel_t end() const { return {}; }
+
+private:
+  std::string_view buffer;
+};
+
+// The same interface over a stream, for callers that can't map their input.
+// Each line is only valid until the next one is read.
+class getlines {
+public:
+  class iterator {
+  public:
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(getlines &source) : source(&source) { ++*this; }
+
+    std::string_view operator*() const { return source->line; }
+
+    iterator &operator++() {
+      done = !std::getline(source->input, source->line);
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    bool operator==(std::default_sentinel_t) const { return done; }
+
+  private:
+    getlines *source = nullptr;
+    bool done = false;
+  };
+
+  explicit getlines(std::istream &input) : input(input) {}
+
+  iterator begin() { return iterator(*this); }
+  std::default_sentinel_t end() const { return {}; }
+
+private:
+  std::istream &input;
+  std::string line;
+};
+
+// A whole file mapped read-only into memory. Like std::ifstream, a file that
+// can't be opened leaves the object closed rather than throwing.
+class mapped_file {
+public:
+  explicit mapped_file(const std::string &path);
+  ~mapped_file();
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  bool is_open() const { return open; }
+
+  std::string_view view() const { return {data, size}; }
+  aoc::lines lines() const { return aoc::lines(view()); }
+
+private:
+  const char *data = nullptr;
+  std::size_t size = 0;
+  bool open = false;
+};
+} // namespace aoc
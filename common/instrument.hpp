@@ -0,0 +1,198 @@
+#pragma once
+
+// Scoped timers and hardware counters for solver phases. Unless the build
+// defines AOC_INSTRUMENT, AOC_SCOPE expands to nothing and AOC_TIMED to its
+// expression, so instrumented code costs nothing in normal builds. Scopes also
+// report allocations when the build tracks them (see alloc.hpp).
+//
+//   AOC_SCOPE("07/part1");               // times the enclosing block
+//   auto r = AOC_TIMED("07/parse", f()); // times one expression
+
+#ifdef AOC_INSTRUMENT
+
+#include "alloc.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define AOC_CONCAT_(a, b) a##b
+#define AOC_CONCAT(a, b) AOC_CONCAT_(a, b)
+#define AOC_SCOPE(name)                                                        \
+  ::aoc::instrument::scope AOC_CONCAT(aoc_scope_, __LINE__)(name)
+#define AOC_TIMED(name, ...)                                                   \
+  [&]() -> decltype(auto) {                                                    \
+    AOC_SCOPE(name);                                                           \
+    return __VA_ARGS__;                                                        \
+  }()
+
+namespace aoc::instrument {
+// cycles, instructions, cache misses, branch misses
+using counts = std::array<std::uint64_t, 4>;
+
+struct totals {
+  std::uint64_t calls = 0;
+  double ns = 0;
+  counts counters{};
+  alloc::stats allocs;
+};
+
+inline std::mutex registry_lock;
+inline std::map<std::string, totals> registry;
+inline bool counters_enabled = false;
+inline std::atomic<bool> counters_open = false;
+
+// One perf_event group per thread, opened the first time it's needed. If the
+// kernel refuses (no PMU, perf_event_paranoid), counters just read zero.
+class perf_group {
+public:
+  perf_group() {
+    if (!counters_enabled) {
+      return;
+    }
+
+    constexpr std::array<std::uint64_t, 4> events = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (std::size_t i = 0; i < events.size(); ++i) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = events[i];
+      attr.disabled = i == 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+
+      int fd = static_cast<int>(
+          ::syscall(SYS_perf_event_open, &attr, 0, -1, fds[0], 0));
+      if (fd < 0) {
+        this->close();
+        return;
+      }
+      fds[i] = fd;
+    }
+
+    ::ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    counters_open = true;
+  }
+
+  ~perf_group() { this->close(); }
+
+  counts read() const {
+    struct {
+      std::uint64_t nr;
+      counts values;
+    } group{};
+
+    if (fds[0] < 0 || ::read(fds[0], &group, sizeof(group)) < 0) {
+      return {};
+    }
+    return group.values;
+  }
+
+private:
+  void close() {
+    for (auto &fd : fds) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+      fd = -1;
+    }
+  }
+
+  std::array<int, 4> fds{-1, -1, -1, -1};
+};
+
+inline const perf_group &thread_counters() {
+  thread_local perf_group group;
+  return group;
+}
+
+class scope {
+public:
+  explicit scope(const char *name)
+      : name(name), start_counts(thread_counters().read()),
+        start(std::chrono::steady_clock::now()) {}
+
+  ~scope() {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    auto end_counts = thread_counters().read();
+    auto used = allocs.stats();
+
+    std::lock_guard guard(registry_lock);
+    auto &entry = registry[name];
+    entry.calls++;
+    entry.ns += std::chrono::duration<double, std::nano>(elapsed).count();
+    for (std::size_t i = 0; i < end_counts.size(); ++i) {
+      entry.counters[i] += end_counts[i] - start_counts[i];
+    }
+
+    entry.allocs.count += used.count;
+    entry.allocs.bytes += used.bytes;
+    entry.allocs.peak = std::max(entry.allocs.peak, used.peak);
+  }
+
+  scope(const scope &) = delete;
+  scope &operator=(const scope &) = delete;
+
+private:
+  const char *name;
+  alloc::phase allocs;
+  counts start_counts;
+  std::chrono::steady_clock::time_point start;
+};
+
+// Counters have to be enabled before the first scope on each thread.
+inline void enable_counters() { counters_enabled = true; }
+
+inline void reset() {
+  std::lock_guard guard(registry_lock);
+  registry.clear();
+}
+
+// Writes every scope as a JSON object keyed by scope name.
+inline void report(std::ostream &out) {
+  std::lock_guard guard(registry_lock);
+  out << '{';
+  for (bool first = true; const auto &[name, t] : registry) {
+    out << (first ? "" : ",") << '"' << name << "\":{\"calls\":" << t.calls
+        << ",\"ns\":" << t.ns;
+    if (counters_open) {
+      out << ",\"cycles\":" << t.counters[0]
+          << ",\"instructions\":" << t.counters[1]
+          << ",\"cache_misses\":" << t.counters[2]
+          << ",\"branch_misses\":" << t.counters[3];
+    }
+    if (alloc::tracking()) {
+      out << ",\"allocs\":" << t.allocs.count
+          << ",\"alloc_bytes\":" << t.allocs.bytes
+          << ",\"alloc_peak\":" << t.allocs.peak;
+    }
+    out << '}';
+    first = false;
+  }
+  out << '}';
+}
+} // namespace aoc::instrument
+
+#else
+
+#define AOC_SCOPE(name) static_cast<void>(0)
+#define AOC_TIMED(name, ...) (__VA_ARGS__)
+
+#endif
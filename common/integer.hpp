@@ -0,0 +1,202 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+// Decimal parsing for the hot paths, in place of std::stoi and friends.
+// Digits are converted eight at a time in a 64 bit word (SWAR), or sixteen at
+// a time with SSSE3 multiply-adds, and every step is checked for overflow.
+//
+//   auto bid = aoc::integer::parse<int>("765");         // 765
+//   auto big = aoc::integer::parse<__int128>(digits);   // 39 digits fit
+//   aoc::integer::parse_each<int>(" 1 21 53", [](int n) { ... });
+namespace aoc::integer {
+namespace detail {
+template <typename T> struct unsigned_of {
+  using type = std::make_unsigned_t<T>;
+};
+template <> struct unsigned_of<__int128> {
+  using type = unsigned __int128;
+};
+template <> struct unsigned_of<unsigned __int128> {
+  using type = unsigned __int128;
+};
+
+constexpr std::uint64_t zeros = 0x3030303030303030;
+
+// Eight ASCII digits with the first in the lowest byte. Adjacent digits are
+// combined pairwise in three multiply-adds; anything but a digit gives
+// nothing.
+inline std::optional<std::uint32_t> eight(std::uint64_t word) {
+  if ((word & 0xF0F0F0F0F0F0F0F0) != zeros ||
+      ((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) != zeros) {
+    return std::nullopt;
+  }
+
+  word -= zeros;
+  word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FF;
+  word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFF;
+  word = (word * 10000 + (word >> 32)) & 0x00000000FFFFFFFF;
+  return static_cast<std::uint32_t>(word);
+}
+
+#if defined(__SSSE3__)
+// Sixteen digits: pairs, then fours, then eights are combined by successive
+// multiply-adds across the lanes of one register.
+inline std::optional<std::uint64_t> sixteen(const char *in) {
+  auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  auto digits = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+  auto bad = _mm_or_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8(9)),
+                          _mm_cmpgt_epi8(_mm_setzero_si128(), digits));
+  if (_mm_movemask_epi8(bad) != 0) {
+    return std::nullopt;
+  }
+
+  auto pairs = _mm_maddubs_epi16(
+      digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1,
+                            10, 1));
+  auto fours =
+      _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+  // every four digit group fits in 16 bits
+  auto packed = _mm_packs_epi32(fours, fours);
+  auto eights = _mm_madd_epi16(
+      packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+  auto high = static_cast<std::uint32_t>(_mm_cvtsi128_si32(eights));
+  auto low = static_cast<std::uint32_t>(
+      _mm_cvtsi128_si32(_mm_srli_si128(eights, 4)));
+  return std::uint64_t(high) * 100000000 + low;
+}
+#endif
+
+// value = value * scale + digits, unless the result wouldn't fit in U
+template <typename U>
+constexpr bool shift_in(U &value, std::uint64_t scale, std::uint64_t digits) {
+  return !__builtin_mul_overflow(value, scale, &value) &&
+         !__builtin_add_overflow(value, digits, &value);
+}
+
+// The magnitude of an unsigned run of digits, or nothing on a non-digit or
+// overflow. In a constant expression, where words can't be loaded from
+// bytes, digits are taken one at a time.
+template <typename U>
+constexpr std::optional<U> magnitude(std::string_view in) {
+  U value = 0;
+  if (std::endian::native != std::endian::little ||
+      std::is_constant_evaluated()) {
+    for (char c : in) {
+      if (c < '0' || c > '9' || !shift_in(value, 10, c - '0')) {
+        return std::nullopt;
+      }
+    }
+    return value;
+  }
+
+  // a short first chunk, right-aligned in a word of '0's, leaves only whole
+  // chunks behind it
+  if (auto head = in.size() % 8; head != 0) {
+    std::uint64_t word = zeros;
+    std::memcpy(reinterpret_cast<char *>(&word) + (8 - head), in.data(), head);
+    auto digits = eight(word);
+    if (!digits) {
+      return std::nullopt;
+    }
+
+    value = *digits;
+    in.remove_prefix(head);
+  }
+
+#if defined(__SSSE3__)
+  for (; in.size() >= 16; in.remove_prefix(16)) {
+    auto digits = sixteen(in.data());
+    if (!digits || !shift_in(value, 10000000000000000, *digits)) {
+      return std::nullopt;
+    }
+  }
+#endif
+
+  for (; !in.empty(); in.remove_prefix(8)) {
+    std::uint64_t word;
+    std::memcpy(&word, in.data(), 8);
+    auto digits = eight(word);
+    if (!digits || !shift_in(value, 100000000, *digits)) {
+      return std::nullopt;
+    }
+  }
+
+  return value;
+}
+} // namespace detail
+
+// Parses the whole of `in` as a decimal number, with a leading '-' for signed
+// types. Works for 32, 64 and 128 bit integers, signed or not. Gives nothing
+// on an empty string, any other character, or a value that doesn't fit.
+// Usable in constant expressions.
+template <typename T> constexpr std::optional<T> parse(std::string_view in) {
+  using U = typename detail::unsigned_of<T>::type;
+  constexpr bool is_signed = T(-1) < T(0);
+
+  bool negative = false;
+  if constexpr (is_signed) {
+    if (!in.empty() && in.front() == '-') {
+      negative = true;
+      in.remove_prefix(1);
+    }
+  }
+
+  if (in.empty()) {
+    return std::nullopt;
+  }
+
+  auto value = detail::magnitude<U>(in);
+  if (!value) {
+    return std::nullopt;
+  }
+
+  if constexpr (is_signed) {
+    constexpr U max = U(-1) >> 1;
+    if (*value > max + (negative ? 1 : 0)) {
+      return std::nullopt;
+    }
+    return static_cast<T>(negative ? U(0) - *value : *value);
+  } else {
+    return static_cast<T>(*value);
+  }
+}
+
+// Parses every number in a run separated by spaces, such as the picks on a
+// card, passing each to `out` in order. Returns false at the first field that
+// isn't a number, after passing along the ones before it.
+template <typename T, typename Out>
+constexpr bool parse_each(std::string_view in, Out &&out) {
+  std::size_t at = 0;
+  while (true) {
+    while (at < in.size() && in[at] == ' ') {
+      ++at;
+    }
+    if (at == in.size()) {
+      return true;
+    }
+
+    auto end = in.find(' ', at);
+    if (end == std::string_view::npos) {
+      end = in.size();
+    }
+
+    auto value = parse<T>(in.substr(at, end - at));
+    if (!value) {
+      return false;
+    }
+
+    out(*value);
+    at = end;
+  }
+}
+} // namespace aoc::integer
@@ -0,0 +1,266 @@
+#pragma once
+#include "arena.hpp"
+#include "input.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aoc {
+// A blocking FIFO holding at most `capacity` items. push() waits for room and
+// pop() for an item; once closed, push() refuses new items and pop() returns
+// nothing after the queue drains.
+template <typename T> class bounded_queue {
+public:
+  explicit bounded_queue(std::size_t capacity)
+      : capacity(std::max<std::size_t>(capacity, 1)) {}
+
+  bool push(T item) {
+    std::unique_lock lock(mutex);
+    not_full.wait(lock, [&] { return closed || items.size() < capacity; });
+    if (closed) {
+      return false;
+    }
+
+    items.push_back(std::move(item));
+    not_empty.notify_one();
+    return true;
+  }
+
+  std::optional<T> pop() {
+    std::unique_lock lock(mutex);
+    not_empty.wait(lock, [&] { return closed || !items.empty(); });
+    if (items.empty()) {
+      return std::nullopt;
+    }
+
+    auto item = std::move(items.front());
+    items.pop_front();
+    not_full.notify_one();
+    return item;
+  }
+
+  void close() {
+    std::lock_guard lock(mutex);
+    closed = true;
+    not_full.notify_all();
+    not_empty.notify_all();
+  }
+
+private:
+  std::size_t capacity;
+  std::deque<T> items;
+  bool closed = false;
+  std::mutex mutex;
+  std::condition_variable not_full, not_empty;
+};
+
+struct pipeline_options {
+  // bytes read per batch; batches are cut at line boundaries
+  std::size_t block_size = 64 * 1024;
+  // batches allowed between the reader and the solver at once
+  std::size_t depth = 16;
+  // parse threads, or 0 for one per hardware thread
+  unsigned workers = 0;
+  // hand records to the solver in input order
+  bool ordered = true;
+};
+
+namespace detail {
+template <typename Record> struct batch {
+  std::size_t sequence = 0;
+  std::string storage;
+  std::string_view text;
+  // declared before the records so they are destroyed first
+  std::unique_ptr<arena> memory;
+  std::vector<Record> records;
+};
+
+template <typename Record, typename Next, typename Parse, typename Solve>
+void run_pipeline(Next &next, Parse &parse, Solve &solve,
+                  const pipeline_options &options) {
+  using batch_ptr = std::unique_ptr<batch<Record>>;
+
+  // Every batch takes a slot in the window when it is read and frees it once
+  // solved, so a slow solver or one slow batch (when ordered) stalls the
+  // reader rather than letting batches pile up.
+  bounded_queue<std::size_t> window(options.depth);
+  bounded_queue<batch_ptr> raw(options.depth), parsed(options.depth);
+
+  std::mutex error_lock;
+  std::exception_ptr error;
+  auto fail = [&] {
+    {
+      std::lock_guard lock(error_lock);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    window.close();
+    raw.close();
+    parsed.close();
+  };
+
+  std::jthread reader([&] {
+    try {
+      for (std::size_t sequence = 0; window.push(sequence); ++sequence) {
+        auto next_batch = std::make_unique<batch<Record>>();
+        next_batch->sequence = sequence;
+        if (!next(*next_batch) || !raw.push(std::move(next_batch))) {
+          break;
+        }
+      }
+    } catch (...) {
+      fail();
+    }
+    raw.close();
+  });
+
+  unsigned workers = options.workers;
+  if (workers == 0) {
+    workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::atomic<unsigned> running = workers;
+  std::vector<std::jthread> parsers;
+  for (unsigned i = 0; i < workers; ++i) {
+    parsers.emplace_back([&] {
+      try {
+        while (auto item = raw.pop()) {
+          auto &current = **item;
+          current.memory = std::make_unique<arena>();
+          for (auto line : lines(current.text)) {
+            current.records.push_back(parse(line, *current.memory));
+          }
+
+          if (!parsed.push(std::move(*item))) {
+            break;
+          }
+        }
+      } catch (...) {
+        fail();
+      }
+
+      if (--running == 0) {
+        parsed.close();
+      }
+    });
+  }
+
+  auto consume = [&](batch<Record> &current) {
+    for (auto &record : current.records) {
+      solve(record);
+    }
+    window.pop();
+  };
+
+  try {
+    std::map<std::size_t, batch_ptr> pending;
+    std::size_t expected = 0;
+    while (auto item = parsed.pop()) {
+      if (!options.ordered) {
+        consume(**item);
+        continue;
+      }
+
+      pending.emplace((*item)->sequence, std::move(*item));
+      while (!pending.empty() && pending.begin()->first == expected) {
+        consume(*pending.begin()->second);
+        pending.erase(pending.begin());
+        ++expected;
+      }
+    }
+  } catch (...) {
+    fail();
+  }
+
+  window.close();
+  raw.close();
+  reader.join();
+  for (auto &parser : parsers) {
+    parser.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+template <typename Parse>
+using record_t = std::invoke_result_t<Parse &, std::string_view, arena &>;
+} // namespace detail
+
+// Runs line-oriented input through read -> parse -> solve stages. One thread
+// reads the input in blocks cut at line boundaries, a pool of workers calls
+// parse(line, arena) on each line, and the calling thread passes every record
+// to solve(record), in input order if options.ordered is set. A batch's
+// records, its text and its arena live until the batch has been solved, so
+// records may point into either.
+template <typename Parse, typename Solve>
+void pipeline(std::istream &input, Parse &&parse, Solve &&solve,
+              const pipeline_options &options = {}) {
+  auto block = std::max<std::size_t>(options.block_size, 1);
+  std::string carry;
+  auto next = [&](detail::batch<detail::record_t<Parse>> &current) {
+    auto &text = current.storage;
+    text = std::move(carry);
+    carry.clear();
+
+    while (true) {
+      auto size = text.size();
+      text.resize(size + block);
+      input.read(text.data() + size, block);
+      text.resize(size + input.gcount());
+      if (!input) {
+        break;
+      }
+
+      // hold back the partial last line for the next batch
+      if (auto cut = text.rfind('\n'); cut != std::string::npos) {
+        carry.assign(text, cut + 1);
+        text.resize(cut + 1);
+        break;
+      }
+    }
+
+    current.text = text;
+    return !text.empty();
+  };
+
+  detail::run_pipeline<detail::record_t<Parse>>(next, parse, solve, options);
+}
+
+template <typename Parse, typename Solve>
+void pipeline(std::string_view input, Parse &&parse, Solve &&solve,
+              const pipeline_options &options = {}) {
+  auto block = std::max<std::size_t>(options.block_size, 1);
+  std::size_t offset = 0;
+  auto next = [&](detail::batch<detail::record_t<Parse>> &current) {
+    if (offset >= input.size()) {
+      return false;
+    }
+
+    auto end = input.find('\n', offset + block - 1);
+    end = end == std::string_view::npos ? input.size() : end + 1;
+    current.text = input.substr(offset, end - offset);
+    offset = end;
+    return true;
+  };
+
+  detail::run_pipeline<detail::record_t<Parse>>(next, parse, solve, options);
+}
+} // namespace aoc
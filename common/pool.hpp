@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace aoc {
+// A fixed set of threads, each with its own deque of jobs. A thread runs its
+// newest job first and, when it runs dry, steals the oldest job from another
+// thread, so one long job only holds up its own thread while the rest of its
+// queue is taken by others.
+//
+// Jobs may submit more jobs; from a worker they go on that worker's own
+// deque. wait() returns once every job, including those, has finished, and
+// rethrows the first exception a job threw.
+class work_pool {
+public:
+  explicit work_pool(unsigned threads = 0) {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned i = 0; i < threads; ++i) {
+      this->queues.push_back(std::make_unique<queue>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+      this->workers.emplace_back([this, i] { this->work(i); });
+    }
+  }
+
+  ~work_pool() {
+    {
+      std::lock_guard lock(this->sleep_lock);
+      this->stopping = true;
+    }
+    this->wake.notify_all();
+    // the jthreads join as they are destroyed
+  }
+
+  work_pool(const work_pool &) = delete;
+  work_pool &operator=(const work_pool &) = delete;
+
+  std::size_t size() const { return this->workers.size(); }
+
+  void submit(std::function<void()> job) {
+    // a worker keeps its own jobs; anyone else deals them out in turn
+    auto index = current == this ? current_index
+                                 : this->next++ % this->queues.size();
+    this->pending.fetch_add(1);
+    {
+      std::lock_guard lock(this->queues[index]->lock);
+      this->queues[index]->jobs.push_back(std::move(job));
+    }
+
+    {
+      std::lock_guard lock(this->sleep_lock);
+      ++this->queued;
+    }
+    this->wake.notify_one();
+  }
+
+  void wait() {
+    std::unique_lock lock(this->sleep_lock);
+    this->done.wait(lock, [this] { return this->pending.load() == 0; });
+    if (this->error) {
+      std::rethrow_exception(std::exchange(this->error, nullptr));
+    }
+  }
+
+private:
+  struct queue {
+    std::mutex lock;
+    std::deque<std::function<void()>> jobs;
+  };
+
+  std::optional<std::function<void()>> take(std::size_t self) {
+    {
+      auto &own = *this->queues[self];
+      std::lock_guard lock(own.lock);
+      if (!own.jobs.empty()) {
+        auto job = std::move(own.jobs.back());
+        own.jobs.pop_back();
+        return job;
+      }
+    }
+
+    for (std::size_t i = 1; i < this->queues.size(); ++i) {
+      auto &other = *this->queues[(self + i) % this->queues.size()];
+      std::lock_guard lock(other.lock);
+      if (!other.jobs.empty()) {
+        auto job = std::move(other.jobs.front());
+        other.jobs.pop_front();
+        return job;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  void work(std::size_t self) {
+    current = this;
+    current_index = self;
+    while (true) {
+      {
+        std::unique_lock lock(this->sleep_lock);
+        this->wake.wait(lock,
+                        [this] { return this->stopping || this->queued > 0; });
+        if (this->queued == 0) {
+          return;
+        }
+        --this->queued;
+      }
+
+      // a job is queued somewhere, though another thread may have claimed
+      // the one we find first; keep looking until one turns up
+      std::optional<std::function<void()>> job;
+      while (!(job = this->take(self))) {
+        std::this_thread::yield();
+      }
+
+      try {
+        (*job)();
+      } catch (...) {
+        std::lock_guard lock(this->sleep_lock);
+        if (!this->error) {
+          this->error = std::current_exception();
+        }
+      }
+
+      // whatever the job captured goes before wait() can return
+      job.reset();
+      if (this->pending.fetch_sub(1) == 1) {
+        std::lock_guard lock(this->sleep_lock);
+        this->done.notify_all();
+      }
+    }
+  }
+
+  static inline thread_local work_pool *current = nullptr;
+  static inline thread_local std::size_t current_index = 0;
+
+  std::vector<std::unique_ptr<queue>> queues;
+  std::atomic<std::size_t> next = 0;
+  // jobs submitted but not yet finished
+  std::atomic<std::size_t> pending = 0;
+
+  std::mutex sleep_lock;
+  std::condition_variable wake, done;
+  // jobs submitted but not yet claimed by a worker
+  std::size_t queued = 0;
+  bool stopping = false;
+  std::exception_ptr error;
+
+  // declared last, so the threads stop before anything they use goes away
+  std::vector<std::jthread> workers;
+};
+} // namespace aoc
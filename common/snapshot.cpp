@@ -0,0 +1,184 @@
+#include "snapshot.hpp"
+#include "input.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace aoc::snapshot {
+namespace {
+constexpr char magic[8] = {'a', 'o', 'c', 's', 'n', 'a', 'p', '\0'};
+constexpr std::uint32_t byte_order = 0x01020304;
+constexpr std::size_t alignment = 64;
+
+struct header {
+  char magic[8];
+  std::uint32_t format;
+  std::uint32_t byte_order;
+  char day[4];
+  std::uint32_t version;
+  std::uint32_t sections;
+  std::uint32_t reserved;
+  std::uint64_t size;
+};
+
+struct entry {
+  std::uint32_t tag;
+  std::uint32_t element;
+  std::uint64_t offset;
+  std::uint64_t count;
+};
+
+static_assert(sizeof(header) == 40 && sizeof(entry) == 24);
+
+std::size_t aligned(std::size_t offset) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+void check(bool ok, const char *what) {
+  if (!ok) {
+    throw std::runtime_error(std::string("bad snapshot: ") + what);
+  }
+}
+
+header read_header(std::string_view bytes) {
+  check(bytes.size() >= sizeof(header), "too short for a header");
+  header out;
+  std::memcpy(&out, bytes.data(), sizeof(out));
+  return out;
+}
+
+entry read_entry(std::string_view bytes, std::size_t i) {
+  entry out;
+  std::memcpy(&out, bytes.data() + sizeof(header) + i * sizeof(entry),
+              sizeof(out));
+  return out;
+}
+} // namespace
+
+bool is_snapshot(std::string_view bytes) {
+  return bytes.size() >= sizeof(magic) &&
+         std::memcmp(bytes.data(), magic, sizeof(magic)) == 0;
+}
+
+writer::writer(std::string_view day, int version)
+    : day(day), version(version) {
+  if (day.size() > 4) {
+    throw std::invalid_argument("snapshot day names are at most 4 bytes");
+  }
+}
+
+void writer::add_bytes(std::uint32_t tag, std::size_t element,
+                       std::size_t count, std::string_view bytes) {
+  this->sections.push_back({tag, static_cast<std::uint32_t>(element), count,
+                            std::string(bytes)});
+}
+
+std::string writer::finish() const {
+  auto offset = aligned(sizeof(header) + this->sections.size() * sizeof(entry));
+  std::vector<entry> table;
+  for (const auto &section : this->sections) {
+    table.push_back({section.tag, section.element, offset, section.count});
+    offset = aligned(offset + section.bytes.size());
+  }
+
+  header head{};
+  std::memcpy(head.magic, magic, sizeof(magic));
+  head.format = format;
+  head.byte_order = byte_order;
+  std::memcpy(head.day, this->day.data(), this->day.size());
+  head.version = this->version;
+  head.sections = this->sections.size();
+  head.size = offset;
+
+  std::string out(offset, '\0');
+  std::memcpy(out.data(), &head, sizeof(head));
+  std::memcpy(out.data() + sizeof(head), table.data(),
+              table.size() * sizeof(entry));
+  for (std::size_t i = 0; i < table.size(); ++i) {
+    std::ranges::copy(this->sections[i].bytes, out.begin() + table[i].offset);
+  }
+  return out;
+}
+
+reader::reader(std::string_view bytes, std::string_view day, int version)
+    : bytes(bytes) {
+  auto head = read_header(bytes);
+  check(is_snapshot(bytes), "no magic number");
+  check(head.format == format, "written by another format version");
+  check(head.byte_order == byte_order, "written with another byte order");
+  check(std::string_view(head.day, strnlen(head.day, sizeof(head.day))) ==
+            day,
+        "written for another day");
+  check(head.version == static_cast<std::uint32_t>(version),
+        "written by another version of the solver");
+  check(head.size == bytes.size(), "truncated or padded");
+
+  auto table_end = sizeof(header) + std::size_t(head.sections) * sizeof(entry);
+  check(table_end <= bytes.size(), "section table out of bounds");
+  for (std::size_t i = 0; i < head.sections; ++i) {
+    auto section = read_entry(bytes, i);
+    check(section.element > 0 && section.offset % alignment == 0 &&
+              section.offset >= table_end && section.offset <= bytes.size(),
+          "section out of bounds");
+    check(section.count <= (bytes.size() - section.offset) / section.element,
+          "section out of bounds");
+  }
+}
+
+std::string_view reader::find(std::uint32_t tag, std::size_t element,
+                              std::size_t alignment) const {
+  auto head = read_header(this->bytes);
+  for (std::size_t i = 0; i < head.sections; ++i) {
+    auto section = read_entry(this->bytes, i);
+    if (section.tag != tag) {
+      continue;
+    }
+
+    check(section.element == element, "records of the wrong size");
+    auto out = this->bytes.substr(section.offset, section.count * element);
+    // sections are aligned within the file, so this only fails for a buffer
+    // that was copied somewhere unaligned
+    check(reinterpret_cast<std::uintptr_t>(out.data()) % alignment == 0,
+          "buffer is not aligned for its records");
+    return out;
+  }
+
+  check(false, "missing a section");
+  return {};
+}
+
+namespace {
+constexpr auto dimensions_tag = tag("dims");
+constexpr auto cells_tag = tag("cell");
+} // namespace
+
+std::string write_grid(std::string_view day, std::string_view text) {
+  std::string cells;
+  std::uint64_t width = 0, height = 0;
+  for (auto line : aoc::lines(text)) {
+    if (height == 0) {
+      width = line.size();
+    } else if (line.size() != width) {
+      throw std::runtime_error("grid rows differ in length");
+    }
+    cells += line;
+    ++height;
+  }
+
+  writer out(day, 0);
+  out.add(dimensions_tag, std::vector<std::uint64_t>{width, height});
+  out.add(cells_tag, std::span<const char>(cells));
+  return out.finish();
+}
+
+grid read_grid(std::string_view bytes, std::string_view day) {
+  reader in(bytes, day, 0);
+  auto dimensions = in.get<std::uint64_t>(dimensions_tag);
+  auto cells = in.get<char>(cells_tag);
+  check(dimensions.size() == 2 &&
+            dimensions[0] * dimensions[1] == cells.size(),
+        "grid dimensions");
+  return {dimensions[0], dimensions[1], {cells.data(), cells.size()}};
+}
+} // namespace aoc::snapshot
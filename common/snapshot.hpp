@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// A flat binary form for parsed models, so large inputs can be parsed once
+// and then mapped and solved in place with no deserialization.
+//
+// A snapshot is a header, a table of sections and then the sections, each an
+// array of fixed-layout records starting on a 64 byte boundary:
+//
+//   header   "aocsnap" magic, format, byte order, day, day version, size
+//   table    per section: tag, record size, offset, record count
+//   data     the records, native byte order
+//
+// The reader checks all of it against the buffer up front and hands out
+// spans into the buffer, which must outlive them. A snapshot written by a
+// different format, day version or byte order is refused rather than read.
+namespace aoc::snapshot {
+inline constexpr std::uint32_t format = 1;
+
+// A section tag from four characters, like tag("seed").
+constexpr std::uint32_t tag(const char (&name)[5]) {
+  return std::uint32_t(static_cast<unsigned char>(name[0])) |
+         std::uint32_t(static_cast<unsigned char>(name[1])) << 8 |
+         std::uint32_t(static_cast<unsigned char>(name[2])) << 16 |
+         std::uint32_t(static_cast<unsigned char>(name[3])) << 24;
+}
+
+// Whether bytes start like a snapshot, to tell them from text input.
+bool is_snapshot(std::string_view bytes);
+
+class writer {
+public:
+  writer(std::string_view day, int version);
+
+  template <typename T> void add(std::uint32_t tag, std::span<const T> items) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->add_bytes(tag, sizeof(T), items.size(),
+                    {reinterpret_cast<const char *>(items.data()),
+                     items.size_bytes()});
+  }
+  template <typename T>
+  void add(std::uint32_t tag, const std::vector<T> &items) {
+    this->add(tag, std::span<const T>(items));
+  }
+
+  // The whole snapshot, ready to be written to a file.
+  std::string finish() const;
+
+private:
+  struct section {
+    std::uint32_t tag;
+    std::uint32_t element;
+    std::uint64_t count;
+    std::string bytes;
+  };
+
+  void add_bytes(std::uint32_t tag, std::size_t element, std::size_t count,
+                 std::string_view bytes);
+
+  std::string day;
+  int version;
+  std::vector<section> sections;
+};
+
+class reader {
+public:
+  // Throws std::runtime_error unless bytes hold a whole snapshot of day at
+  // version.
+  reader(std::string_view bytes, std::string_view day, int version);
+
+  // The records of a section, which must exist and hold records of T.
+  template <typename T> std::span<const T> get(std::uint32_t tag) const {
+    static_assert(std::is_trivially_copyable_v<T>);
+    auto bytes = this->find(tag, sizeof(T), alignof(T));
+    return {reinterpret_cast<const T *>(bytes.data()),
+            bytes.size() / sizeof(T)};
+  }
+
+private:
+  std::string_view find(std::uint32_t tag, std::size_t element,
+                        std::size_t alignment) const;
+
+  std::string_view bytes;
+};
+
+// A rectangular grid of bytes, such as day 03's schematic, kept as its rows
+// without newlines. A grid is the input itself rather than something a
+// solver derived from it, so it carries no day version.
+struct grid {
+  std::size_t width = 0;
+  std::size_t height = 0;
+  std::string_view cells;
+
+  std::string_view row(std::size_t y) const {
+    return cells.substr(y * width, width);
+  }
+};
+
+// Throws std::runtime_error if the lines of text differ in length.
+std::string write_grid(std::string_view day, std::string_view text);
+grid read_grid(std::string_view bytes, std::string_view day);
+} // namespace aoc::snapshot
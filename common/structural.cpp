@@ -0,0 +1,110 @@
+#include "structural.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace aoc {
+namespace {
+constexpr std::size_t block = 64;
+
+struct masks {
+  std::uint64_t structural;
+  std::uint64_t newline;
+};
+
+// One bit per byte of a 64 byte block. With SSE2 each 16 byte lane is
+// compared against every structural character at once and the results are
+// packed with movemask.
+masks classify(const char *in) {
+#if defined(__SSE2__)
+  masks out{0, 0};
+  for (int lane = 0; lane < 4; ++lane) {
+    auto bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + lane * 16));
+    auto newline = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'));
+    auto any = newline;
+    for (char c : structural_characters.substr(1)) {
+      any = _mm_or_si128(any, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(c)));
+    }
+
+    auto shift = lane * 16;
+    out.structural |=
+        static_cast<std::uint64_t>(_mm_movemask_epi8(any) & 0xFFFF) << shift;
+    out.newline |= static_cast<std::uint64_t>(_mm_movemask_epi8(newline) &
+                                              0xFFFF)
+                   << shift;
+  }
+
+  return out;
+#else
+  masks out{0, 0};
+  for (std::size_t i = 0; i < block; ++i) {
+    if (structural_characters.find(in[i]) != std::string_view::npos) {
+      out.structural |= std::uint64_t(1) << i;
+    }
+    if (in[i] == '\n') {
+      out.newline |= std::uint64_t(1) << i;
+    }
+  }
+
+  return out;
+#endif
+}
+} // namespace
+
+structural_index::structural_index(std::string_view buffer) : input(buffer) {
+  if (buffer.size() > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error("buffer too large to index");
+  }
+
+  // a rough guess, roughly one field per five bytes in these formats
+  this->positions.reserve(buffer.size() / 4);
+
+  auto flatten = [this](masks found, std::uint32_t base) {
+    while (found.structural != 0) {
+      auto bit = std::countr_zero(found.structural);
+      if ((found.newline >> bit) & 1) {
+        this->breaks.push_back(this->positions.size());
+      }
+      this->positions.push_back(base + bit);
+      found.structural &= found.structural - 1;
+    }
+  };
+
+  std::size_t offset = 0;
+  for (; offset + block <= buffer.size(); offset += block) {
+    flatten(classify(buffer.data() + offset), offset);
+  }
+
+  // the tail is padded with bytes that aren't structural
+  if (offset < buffer.size()) {
+    std::array<char, block> tail{};
+    std::memcpy(tail.data(), buffer.data() + offset, buffer.size() - offset);
+    flatten(classify(tail.data()), offset);
+  }
+
+  std::size_t consumed =
+      this->breaks.empty() ? 0 : this->positions[this->breaks.back()] + 1;
+  this->lines = this->breaks.size() + (consumed < buffer.size() ? 1 : 0);
+}
+
+std::string_view structural_index::line(std::size_t i) const {
+  std::size_t start = i == 0 ? 0 : this->positions[this->breaks[i - 1]] + 1;
+  std::size_t end = i < this->breaks.size() ? this->positions[this->breaks[i]]
+                                            : this->input.size();
+  return this->input.substr(start, end - start);
+}
+
+std::span<const std::uint32_t>
+structural_index::structurals(std::size_t i) const {
+  auto from = this->first(i);
+  return std::span(this->positions).subspan(from, this->last(i) - from);
+}
+} // namespace aoc
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace aoc {
+// The bytes every puzzle format splits its fields on: newlines, spaces, the
+// ':' after a header, the '|' in a card and the ';' and ',' between rounds.
+inline constexpr std::string_view structural_characters = "\n :|;,";
+
+// The offsets of every structural byte in a buffer, found in one vectorized
+// pass before any field is read. The buffer is classified 64 bytes at a time
+// into bitmasks, which are then flattened into offsets, much like the first
+// stage of simdjson. A field is whatever lies between two structurals, and
+// because line boundaries are known up front, lines can be handed out to
+// threads without scanning for them first.
+//
+// The index refers to the buffer, which must outlive it. Offsets are 32 bits,
+// so buffers are limited to 4 GiB.
+class structural_index {
+public:
+  explicit structural_index(std::string_view buffer);
+
+  std::string_view buffer() const { return input; }
+
+  // Every structural offset in the buffer, newlines included, in order.
+  std::span<const std::uint32_t> structurals() const { return positions; }
+
+  // Lines are counted like aoc::lines: a trailing newline does not start an
+  // empty last line.
+  std::size_t line_count() const { return lines; }
+  std::string_view line(std::size_t i) const;
+
+  // The structural offsets within line i, not counting its newline.
+  std::span<const std::uint32_t> structurals(std::size_t i) const;
+
+private:
+  std::size_t first(std::size_t i) const {
+    return i == 0 ? 0 : breaks[i - 1] + 1;
+  }
+  std::size_t last(std::size_t i) const {
+    return i < breaks.size() ? breaks[i] : positions.size();
+  }
+
+  std::string_view input;
+  std::vector<std::uint32_t> positions;
+  // indices into positions of each newline
+  std::vector<std::uint32_t> breaks;
+  std::size_t lines = 0;
+};
+} // namespace aoc
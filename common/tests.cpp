@@ -0,0 +1,136 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "cache.hpp"
+#include "integer.hpp"
+#include "pool.hpp"
+#include "structural.hpp"
+#include <atomic>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+TEST_CASE("structural-index") {
+  // long enough to cross a 64 byte block, with no trailing newline
+  std::string_view input =
+      "Card 1: 41 48 83 86 17 | 83 86  6 31 17  9 48 53\n"
+      "\n"
+      "Game 2: 3 blue; 4 red";
+  aoc::structural_index index(input);
+
+  REQUIRE(index.line_count() == 3);
+  CHECK(index.line(1).empty());
+  CHECK(index.line(2) == "Game 2: 3 blue; 4 red");
+
+  auto fields = index.structurals(0);
+  CHECK(fields.size() == 19);
+  CHECK(input[fields[1]] == ':');
+  CHECK(input[fields[8]] == '|');
+  CHECK(index.structurals(1).empty());
+  CHECK(index.structurals(2).size() == 7);
+  CHECK(input[index.structurals(2)[4]] == ';');
+  // both newlines are structurals too
+  CHECK(index.structurals().size() == 19 + 2 + 7);
+
+  CHECK(aoc::structural_index("").line_count() == 0);
+  CHECK(aoc::structural_index("\n").line_count() == 1);
+}
+
+TEST_CASE("integer") {
+  using aoc::integer::parse;
+  CHECK(parse<int>("7") == 7);
+  CHECK(parse<int>("0000000000000042") == 42);
+  CHECK(parse<int>("2147483647") == 2147483647);
+  CHECK(parse<int>("-2147483648") == -2147483647 - 1);
+  CHECK_FALSE(parse<int>("2147483648"));
+  CHECK_FALSE(parse<unsigned>("-1"));
+  CHECK_FALSE(parse<int>(""));
+  CHECK_FALSE(parse<int>("-"));
+  CHECK_FALSE(parse<int>("12 3"));
+
+  // every chunk size: a short head, whole words and sixteen digit runs
+  CHECK(parse<long>("1234567890123456789") == 1234567890123456789);
+  CHECK_FALSE(parse<long>("9223372036854775808"));
+  CHECK(parse<unsigned long>("18446744073709551615") ==
+        18446744073709551615ul);
+  CHECK_FALSE(parse<unsigned long>("18446744073709551616"));
+  // a bad byte inside a sixteen digit run, above '9' and below '0'
+  CHECK_FALSE(parse<long>("123456789012345x789"));
+  CHECK_FALSE(parse<long>("1234567890/2345678"));
+  CHECK_FALSE(parse<long>("123456789012345\xff789"));
+
+  auto big = parse<__int128>("170141183460469231731687303715884105727");
+  REQUIRE(big);
+  CHECK(*big == static_cast<__int128>(~static_cast<unsigned __int128>(0) >> 1));
+  CHECK_FALSE(parse<__int128>("170141183460469231731687303715884105728"));
+
+  std::vector<int> picks;
+  CHECK(aoc::integer::parse_each<int>(" 83 86  6 31",
+                                      [&](int n) { picks.push_back(n); }));
+  CHECK(picks == std::vector{83, 86, 6, 31});
+  CHECK_FALSE(aoc::integer::parse_each<int>("1 x", [](int) {}));
+}
+
+TEST_CASE("work-pool") {
+  aoc::work_pool pool(3);
+  std::atomic<int> sum = 0;
+  for (int i = 0; i < 8; ++i) {
+    pool.submit([&, i] {
+      // jobs submitted from a job land on its own worker, to be stolen
+      for (int j = 0; j < 4; ++j) {
+        pool.submit([&, i, j] { sum += i * 4 + j; });
+      }
+    });
+  }
+  pool.wait();
+  CHECK(sum == 31 * 32 / 2);
+
+  pool.submit([] { throw std::runtime_error("failed"); });
+  CHECK_THROWS(pool.wait());
+  pool.submit([&] { sum = 0; });
+  pool.wait();
+  CHECK(sum == 0);
+}
+
+TEST_CASE("cache") {
+  constexpr std::string_view input = "Time:      7  15   30\n"
+                                     "Distance:  9  40  200\n";
+  auto dir = std::filesystem::temp_directory_path() /
+             ("aoc-cache-test-" + std::to_string(::getpid()));
+  std::filesystem::remove_all(dir);
+
+  CHECK(aoc::cache::hash(input) == aoc::cache::hash(input));
+  CHECK(aoc::cache::hash(input) != aoc::cache::hash(input.substr(1)));
+  CHECK(aoc::cache::hash("") != aoc::cache::hash(std::string(1, '\0')));
+
+  {
+    aoc::cache::store cache(dir, 2048);
+    aoc::cache::key key{"06", "1", 1, aoc::cache::hash(input), input.size()};
+    CHECK_FALSE(cache.get(key));
+    cache.put(key, 288);
+    CHECK(cache.get(key) == 288);
+
+    // any change to the solver or the input is a miss
+    auto bumped = key;
+    ++bumped.version;
+    CHECK_FALSE(cache.get(bumped));
+    auto other = key;
+    other.part = "2";
+    CHECK_FALSE(cache.get(other));
+
+    // writes past the limit evict the oldest entries
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+      cache.put({"06", "1", 1, i, 1}, static_cast<long>(i));
+    }
+    std::uintmax_t total = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+      total += entry.file_size();
+    }
+    CHECK(total < 4096);
+  }
+
+  std::filesystem::remove_all(dir);
+}
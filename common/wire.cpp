@@ -0,0 +1,239 @@
+#include "wire.hpp"
+#include "integer.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace aoc::wire {
+namespace {
+sockaddr_un address(const std::string &path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    throw std::runtime_error("socket path too long: " + path);
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  return addr;
+}
+
+int open_socket() {
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "socket");
+  }
+  return fd;
+}
+
+std::vector<std::string_view> fields(std::string_view line) {
+  std::vector<std::string_view> out;
+  while (!line.empty()) {
+    auto end = line.find(' ');
+    out.push_back(line.substr(0, end));
+    if (end == std::string_view::npos) {
+      break;
+    }
+    line.remove_prefix(end + 1);
+  }
+  return out;
+}
+
+template <typename T> T number(std::string_view field) {
+  auto value = aoc::integer::parse<T>(field);
+  if (!value) {
+    throw std::runtime_error("bad number in message: " + std::string(field));
+  }
+  return *value;
+}
+} // namespace
+
+socket socket::listen(const std::string &path) {
+  auto addr = address(path);
+  socket out(open_socket());
+  ::unlink(path.c_str());
+  if (::bind(out.fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      ::listen(out.fd, SOMAXCONN) != 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  return out;
+}
+
+socket socket::connect(const std::string &path) {
+  auto addr = address(path);
+  socket out(open_socket());
+  if (::connect(out.fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) !=
+      0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  return out;
+}
+
+socket::~socket() {
+  if (this->fd >= 0) {
+    ::close(this->fd);
+  }
+}
+
+socket::socket(socket &&other) noexcept
+    : fd(std::exchange(other.fd, -1)), buffer(std::move(other.buffer)),
+      at(other.at) {}
+
+socket &socket::operator=(socket &&other) noexcept {
+  std::swap(this->fd, other.fd);
+  std::swap(this->buffer, other.buffer);
+  std::swap(this->at, other.at);
+  return *this;
+}
+
+socket socket::accept() const {
+  while (true) {
+    int fd = ::accept(this->fd, nullptr, nullptr);
+    if (fd >= 0) {
+      return socket(fd);
+    }
+    // a client that gave up while queued isn't the listener's problem
+    if (errno != EINTR && errno != ECONNABORTED) {
+      throw std::system_error(errno, std::generic_category(), "accept");
+    }
+  }
+}
+
+// Appends whatever the peer has sent, dropping what has been read already.
+bool socket::fill() {
+  this->buffer.erase(0, this->at);
+  this->at = 0;
+
+  constexpr std::size_t chunk = 64 * 1024;
+  auto size = this->buffer.size();
+  this->buffer.resize(size + chunk);
+  while (true) {
+    auto got = ::read(this->fd, this->buffer.data() + size, chunk);
+    if (got >= 0) {
+      this->buffer.resize(size + got);
+      return got > 0;
+    }
+    if (errno != EINTR) {
+      this->buffer.resize(size);
+      throw std::system_error(errno, std::generic_category(), "read");
+    }
+  }
+}
+
+std::optional<std::string> socket::read_line() {
+  std::size_t searched = this->at;
+  while (true) {
+    auto end = this->buffer.find('\n', searched);
+    if (end != std::string::npos) {
+      auto line = this->buffer.substr(this->at, end - this->at);
+      this->at = end + 1;
+      return line;
+    }
+
+    searched = this->buffer.size() - this->at;
+    if (!this->fill()) {
+      if (this->at < this->buffer.size()) {
+        throw std::runtime_error("stream ended mid-line");
+      }
+      return std::nullopt;
+    }
+  }
+}
+
+std::string socket::read(std::size_t n) {
+  while (this->buffer.size() - this->at < n) {
+    if (!this->fill()) {
+      throw std::runtime_error("stream ended mid-message");
+    }
+  }
+
+  auto out = this->buffer.substr(this->at, n);
+  this->at += n;
+  return out;
+}
+
+void socket::write(std::string_view data) const {
+  while (!data.empty()) {
+    auto sent = ::send(this->fd, data.data(), data.size(), MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "send");
+    }
+    data.remove_prefix(sent);
+  }
+}
+
+void socket::finish() const { ::shutdown(this->fd, SHUT_WR); }
+
+void socket::shutdown() const { ::shutdown(this->fd, SHUT_RDWR); }
+
+std::optional<request> read_request(socket &from) {
+  auto line = from.read_line();
+  if (!line) {
+    return std::nullopt;
+  }
+
+  auto header = fields(*line);
+  if (header.size() != 4) {
+    throw std::runtime_error("bad request: " + *line);
+  }
+
+  request out{number<std::uint64_t>(header[0]), std::string(header[1]),
+              std::string(header[2]), {}};
+  out.input = from.read(number<std::size_t>(header[3]));
+  return out;
+}
+
+std::optional<response> read_response(socket &from) {
+  auto line = from.read_line();
+  if (!line) {
+    return std::nullopt;
+  }
+
+  auto header = fields(*line);
+  if (header.size() >= 2 && header[1] == "error") {
+    // everything after "ID error "
+    auto reason = line->substr(std::min(line->size(), header[0].size() + 7));
+    return response{number<std::uint64_t>(header[0]), std::nullopt, 0, 0,
+                    std::move(reason)};
+  }
+  if (header.size() != 5 || header[1] != "ok") {
+    throw std::runtime_error("bad response: " + *line);
+  }
+
+  return response{number<std::uint64_t>(header[0]), number<long>(header[2]),
+                  number<std::uint64_t>(header[3]),
+                  number<std::uint64_t>(header[4]),
+                  {}};
+}
+
+void write_request(const socket &to, const request &message) {
+  to.write(std::to_string(message.id) + ' ' + message.day + ' ' +
+           message.part + ' ' + std::to_string(message.input.size()) + '\n');
+  to.write(message.input);
+}
+
+void write_response(const socket &to, const response &message) {
+  auto line = std::to_string(message.id);
+  if (message.answer) {
+    line += " ok " + std::to_string(*message.answer) + ' ' +
+            std::to_string(message.parse_ns) + ' ' +
+            std::to_string(message.solve_ns);
+  } else {
+    // the message is the rest of the line, so it can't hold a newline
+    auto reason = message.error;
+    std::ranges::replace(reason, '\n', ' ');
+    line += " error " + reason;
+  }
+  to.write(line + '\n');
+}
+} // namespace aoc::wire
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// The protocol between `aoc serve` and its clients, over a Unix domain stream
+// socket. Every message is a header line, and a request is followed by the
+// input it names:
+//
+//   request:  "ID DAY PART LENGTH\n" and then LENGTH bytes of input
+//   response: "ID ok ANSWER PARSE_NS SOLVE_NS\n" or "ID error MESSAGE\n"
+//
+// A response carries the id of its request and they may come back in any
+// order, so a client can keep many requests in flight on one connection.
+namespace aoc::wire {
+class socket {
+public:
+  // Binds and listens on path, replacing a stale socket left there.
+  static socket listen(const std::string &path);
+  static socket connect(const std::string &path);
+
+  explicit socket(int fd) : fd(fd) {}
+  ~socket();
+
+  socket(socket &&other) noexcept;
+  socket &operator=(socket &&other) noexcept;
+  socket(const socket &) = delete;
+  socket &operator=(const socket &) = delete;
+
+  socket accept() const;
+
+  // Reads are buffered and meant for one thread at a time. The next line,
+  // without its newline, or nothing at the end of the stream.
+  std::optional<std::string> read_line();
+  // Exactly n bytes; throws if the stream ends first.
+  std::string read(std::size_t n);
+
+  // Writes all of data or throws; a closed peer is an error, not a signal.
+  void write(std::string_view data) const;
+  // Tells the peer nothing more is coming, while still reading its replies.
+  void finish() const;
+  // Ends the stream both ways, so a read blocked on it in another thread
+  // returns.
+  void shutdown() const;
+
+private:
+  bool fill();
+
+  int fd = -1;
+  std::string buffer;
+  std::size_t at = 0;
+};
+
+struct request {
+  std::uint64_t id = 0;
+  std::string day;
+  std::string part;
+  std::string input;
+};
+
+struct response {
+  std::uint64_t id = 0;
+  // nothing if the request failed, with the reason in error
+  std::optional<long> answer;
+  std::uint64_t parse_ns = 0;
+  std::uint64_t solve_ns = 0;
+  std::string error;
+};
+
+// Both give nothing at the end of the stream and throw on a malformed
+// message.
+std::optional<request> read_request(socket &from);
+std::optional<response> read_response(socket &from);
+
+void write_request(const socket &to, const request &message);
+void write_response(const socket &to, const response &message);
+} // namespace aoc::wire
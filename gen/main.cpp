@@ -0,0 +1,593 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+struct Options {
+  long size = 1000;
+  std::uint64_t seed = 2023;
+  int width = 140;
+  int height = 140;
+  double density = 0.05;
+  int stages = 7;
+  int entries = 30;
+};
+
+// A solver's answer is only reported when it fits the type the solver
+// returns; larger inputs still make useful benchmarks.
+struct Answers {
+  std::optional<long> part1;
+  std::optional<long> part2;
+};
+
+std::optional<long> fits_int(__int128 value) {
+  if (value < INT_MIN || value > INT_MAX) {
+    return std::nullopt;
+  }
+  return static_cast<long>(value);
+}
+
+std::optional<long> fits_long(__int128 value) {
+  if (value < LONG_MIN || value > LONG_MAX) {
+    return std::nullopt;
+  }
+  return static_cast<long>(value);
+}
+
+// Draws are done by hand rather than with std distributions, whose results
+// differ between standard libraries, so a seed means the same input
+// everywhere.
+class Random {
+public:
+  explicit Random(std::uint64_t seed) : rng(seed) {}
+
+  // uniform in [lo, hi]
+  long between(long lo, long hi) {
+    auto span = static_cast<std::uint64_t>(hi - lo + 1);
+    return lo + static_cast<long>(rng() % span);
+  }
+
+  bool chance(double p) {
+    return static_cast<double>(rng() >> 11) * 0x1.0p-53 < p;
+  }
+
+  template <typename T> const T &pick(const std::vector<T> &from) {
+    return from[between(0, static_cast<long>(from.size()) - 1)];
+  }
+
+private:
+  std::mt19937_64 rng;
+};
+
+constexpr std::array<std::string_view, 9> digit_words = {
+    "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+
+Answers calibration(std::ostream &out, const Options &options, Random &rng) {
+  // none of these letters appear in a digit word, so filler never forms one
+  constexpr std::string_view filler = "abcdjklmpqyz";
+
+  __int128 part1 = 0, part2 = 0;
+  for (long n = 0; n < options.size; ++n) {
+    std::string line;
+    int first_digit = -1, last_digit = -1, first = -1, last = -1;
+
+    auto tokens = rng.between(1, 5);
+    auto numeric = rng.between(0, tokens - 1);
+    for (long t = 0; t < tokens; ++t) {
+      for (auto f = rng.between(t == 0 ? 0 : 1, 4); f > 0; --f) {
+        line += filler[rng.between(0, filler.size() - 1)];
+      }
+
+      int digit = static_cast<int>(rng.between(1, 9));
+      if (t == numeric || rng.chance(0.5)) {
+        line += static_cast<char>('0' + digit);
+        first_digit = first_digit < 0 ? digit : first_digit;
+        last_digit = digit;
+      } else {
+        line += digit_words[digit - 1];
+      }
+      first = first < 0 ? digit : first;
+      last = digit;
+    }
+    for (auto f = rng.between(0, 4); f > 0; --f) {
+      line += filler[rng.between(0, filler.size() - 1)];
+    }
+
+    out << line << '\n';
+    part1 += first_digit * 10 + last_digit;
+    part2 += first * 10 + last;
+  }
+
+  return {fits_int(part1), fits_int(part2)};
+}
+
+Answers games(std::ostream &out, const Options &options, Random &rng) {
+  constexpr std::array<std::string_view, 3> colors = {"red", "green", "blue"};
+  constexpr std::array<int, 3> limits = {12, 13, 14};
+
+  __int128 part1 = 0, part2 = 0;
+  for (long id = 1; id <= options.size; ++id) {
+    out << "Game " << id << ": ";
+
+    std::array<int, 3> most{};
+    for (auto r = rng.between(1, 6); r > 0; --r) {
+      std::array<int, 3> order = {0, 1, 2};
+      for (int i = 2; i > 0; --i) {
+        std::swap(order[i], order[rng.between(0, i)]);
+      }
+
+      auto shown = rng.between(1, 3);
+      for (long c = 0; c < shown; ++c) {
+        int count = static_cast<int>(rng.between(1, 20));
+        most[order[c]] = std::max(most[order[c]], count);
+        out << count << ' ' << colors[order[c]] << (c + 1 < shown ? ", " : "");
+      }
+      out << (r > 1 ? "; " : "\n");
+    }
+
+    bool possible = true;
+    for (int c = 0; c < 3; ++c) {
+      possible = possible && most[c] <= limits[c];
+    }
+    part1 += possible ? id : 0;
+    part2 += most[0] * most[1] * most[2];
+  }
+
+  return {fits_int(part1), fits_int(part2)};
+}
+
+Answers schematic(std::ostream &out, const Options &options, Random &rng) {
+  constexpr std::string_view symbols = "*#+$/@=%&-";
+  const int width = options.width, height = options.height;
+
+  // number ids per cell, -1 when the cell holds no digit
+  std::vector<std::string> grid(height, std::string(width, '.'));
+  std::vector<std::vector<int>> ids(height, std::vector<int>(width, -1));
+  std::vector<long> numbers;
+
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      if (rng.chance(options.density)) {
+        grid[y][x] = symbols[rng.between(0, symbols.size() - 1)];
+      } else if (rng.chance(0.15)) {
+        auto value = rng.between(1, 999);
+        auto digits = std::to_string(value);
+        if (x + static_cast<int>(digits.size()) > width) {
+          continue;
+        }
+
+        for (auto d : digits) {
+          grid[y][x] = d;
+          ids[y][x++] = static_cast<int>(numbers.size());
+        }
+        numbers.push_back(value);
+        // leave the cell after a number empty so numbers never merge
+      }
+    }
+  }
+
+  __int128 part1 = 0, part2 = 0;
+  std::vector<bool> counted(numbers.size());
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      char c = grid[y][x];
+      if (c == '.' || std::isdigit(c)) {
+        continue;
+      }
+
+      std::set<int> adjacent;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          int ny = y + dy, nx = x + dx;
+          if (ny >= 0 && ny < height && nx >= 0 && nx < width &&
+              ids[ny][nx] >= 0) {
+            adjacent.insert(ids[ny][nx]);
+          }
+        }
+      }
+
+      for (auto id : adjacent) {
+        if (!counted[id]) {
+          counted[id] = true;
+          part1 += numbers[id];
+        }
+      }
+      if (c == '*' && adjacent.size() == 2) {
+        part2 += numbers[*adjacent.begin()] * numbers[*adjacent.rbegin()];
+      }
+    }
+  }
+
+  for (const auto &row : grid) {
+    out << row << '\n';
+  }
+
+  return {fits_int(part1), fits_int(part2)};
+}
+
+Answers scratchcards(std::ostream &out, const Options &options, Random &rng) {
+  constexpr int winning = 10, picks = 25;
+  const long cards = options.size;
+
+  __int128 part1 = 0, part2 = 0;
+  std::vector<__int128> copies(cards, 1);
+  for (long i = 0; i < cards; ++i) {
+    std::vector<int> pool(99);
+    std::iota(pool.begin(), pool.end(), 1);
+    for (int j = 0; j < winning + picks; ++j) {
+      std::swap(pool[j], pool[rng.between(j, 98)]);
+    }
+
+    // mostly losing cards keep the number of copies from exploding
+    auto matches = rng.chance(0.6) ? 0 : rng.between(1, 4);
+    matches = std::min(matches, cards - 1 - i);
+
+    std::vector<int> win(pool.begin(), pool.begin() + winning);
+    std::vector<int> pick(pool.begin() + winning,
+                          pool.begin() + winning + picks);
+    for (long m = 0; m < matches; ++m) {
+      pick[m] = win[m];
+    }
+    for (int j = picks - 1; j > 0; --j) {
+      std::swap(pick[j], pick[rng.between(0, j)]);
+    }
+
+    out << "Card " << std::string(std::to_string(cards).size() -
+                                      std::to_string(i + 1).size(),
+                                  ' ')
+        << i + 1 << ":";
+    for (auto n : win) {
+      out << (n < 10 ? "  " : " ") << n;
+    }
+    out << " |";
+    for (auto n : pick) {
+      out << (n < 10 ? "  " : " ") << n;
+    }
+    out << '\n';
+
+    part1 += matches > 0 ? __int128{1} << (matches - 1) : 0;
+    for (long m = 1; m <= matches; ++m) {
+      copies[i + m] += copies[i];
+    }
+    part2 += copies[i];
+  }
+
+  return {fits_int(part1), fits_int(part2)};
+}
+
+std::string stage_name(int stage, int stages) {
+  constexpr std::array<std::string_view, 8> names = {
+      "seed",  "soil",        "fertilizer", "water",
+      "light", "temperature", "humidity",   "location"};
+  if (stage == 0) {
+    return "seed";
+  }
+  if (stage == stages) {
+    return "location";
+  }
+  if (stages == 7) {
+    return std::string(names[stage]);
+  }
+
+  // identifiers are letters only
+  std::string name = "stage";
+  for (int n = stage; n > 0; n /= 26) {
+    name += static_cast<char>('a' + n % 26);
+  }
+  return name;
+}
+
+Answers almanac(std::ostream &out, const Options &options, Random &rng) {
+  constexpr long limit = INT_MAX;
+  struct Entry {
+    long dest, source, length;
+  };
+
+  auto seeds = std::max(2L, options.size - options.size % 2);
+  std::vector<long> values;
+  out << "seeds:";
+  for (long i = 0; i < seeds; i += 2) {
+    auto start = rng.between(0, limit / 2);
+    // ranges shrink as seeds are added, but never below one seed
+    auto length = rng.between(1, std::max(1L, limit / (4 * seeds)));
+    values.push_back(start);
+    values.push_back(length);
+    out << ' ' << start << ' ' << length;
+  }
+  out << "\n\n";
+
+  std::vector<std::vector<Entry>> maps;
+  for (int stage = 0; stage < options.stages; ++stage) {
+    std::set<long> cuts;
+    while (static_cast<long>(cuts.size()) < 2L * options.entries) {
+      cuts.insert(rng.between(0, limit));
+    }
+
+    std::vector<Entry> entries;
+    for (auto it = cuts.begin(); it != cuts.end(); std::advance(it, 2)) {
+      long source = *it, length = *std::next(it) - source;
+      entries.push_back({rng.between(0, limit - length), source, length});
+    }
+    for (std::size_t j = entries.size() - 1; j > 0; --j) {
+      std::swap(entries[j], entries[rng.between(0, j)]);
+    }
+
+    out << stage_name(stage, options.stages) << "-to-"
+        << stage_name(stage + 1, options.stages) << " map:\n";
+    for (auto [dest, source, length] : entries) {
+      out << dest << ' ' << source << ' ' << length << '\n';
+    }
+    out << (stage + 1 < options.stages ? "\n" : "");
+
+    std::ranges::sort(entries, {}, &Entry::source);
+    maps.push_back(entries);
+  }
+
+  auto lookup = [](const std::vector<Entry> &entries, long value) {
+    for (auto [dest, source, length] : entries) {
+      if (value >= source && value < source + length) {
+        return dest + value - source;
+      }
+    }
+    return value;
+  };
+
+  long part1 = LONG_MAX;
+  for (auto value : values) {
+    for (const auto &entries : maps) {
+      value = lookup(entries, value);
+    }
+    part1 = std::min(part1, value);
+  }
+
+  // part 2 pushes half-open ranges through each map, splitting at entries
+  std::vector<std::pair<long, long>> ranges;
+  for (std::size_t i = 0; i < values.size(); i += 2) {
+    ranges.emplace_back(values[i], values[i] + values[i + 1]);
+  }
+  for (const auto &entries : maps) {
+    std::vector<std::pair<long, long>> next;
+    for (auto [left, right] : ranges) {
+      for (auto [dest, source, length] : entries) {
+        if (left >= right) {
+          break;
+        }
+        if (source + length <= left || source >= right) {
+          continue;
+        }
+        if (left < source) {
+          next.emplace_back(left, source);
+          left = source;
+        }
+        long end = std::min(right, source + length);
+        next.emplace_back(dest + left - source, dest + end - source);
+        left = end;
+      }
+      if (left < right) {
+        next.emplace_back(left, right);
+      }
+    }
+    ranges = next;
+  }
+  long part2 = std::ranges::min(ranges).first;
+
+  return {fits_int(part1), fits_int(part2)};
+}
+
+Answers races(std::ostream &out, const Options &options, Random &rng) {
+  std::vector<long> times, distances;
+  for (long i = 0; i < options.size; ++i) {
+    auto time = rng.between(7, 100);
+    times.push_back(time);
+    auto best = (time / 2) * (time - time / 2);
+    distances.push_back(rng.between(time - 1, best - 1));
+  }
+
+  auto line = [&out](std::string_view label, const std::vector<long> &values) {
+    out << label;
+    for (auto v : values) {
+      out << "  " << v;
+    }
+    out << '\n';
+  };
+  line("Time:    ", times);
+  line("Distance:", distances);
+
+  // holding for t wins when t * (time - t) > distance
+  auto wins = [](__int128 time, __int128 distance) -> __int128 {
+    __int128 lo = 0, hi = time / 2;
+    if (hi * (time - hi) <= distance) {
+      return 0;
+    }
+    while (lo < hi) {
+      auto mid = (lo + hi) / 2;
+      if (mid * (time - mid) > distance) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return time - 2 * lo + 1;
+  };
+
+  __int128 part1 = 1;
+  std::string time, distance;
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    if (part1 <= INT_MAX) {
+      part1 *= wins(times[i], distances[i]);
+    }
+    time += std::to_string(times[i]);
+    distance += std::to_string(distances[i]);
+  }
+
+  // the solver checks every hold time, so only report what it can compute
+  std::optional<long> part2;
+  if (time.size() <= 10 && distance.size() <= 18) {
+    part2 = fits_long(wins(std::stol(time), std::stol(distance)));
+  }
+
+  return {fits_int(part1), part2};
+}
+
+Answers hands(std::ostream &out, const Options &options, Random &rng) {
+  constexpr std::string_view faces = "23456789TJQKA";
+  constexpr std::string_view joker_faces = "J23456789TQKA";
+  if (options.size > 13 * 13 * 13 * 13 * 13) {
+    throw std::runtime_error("hands must be distinct, at most 13^5 of them");
+  }
+
+  auto strength = [](std::string_view hand, std::string_view order,
+                     bool jokers) {
+    std::map<char, int> counts;
+    for (auto c : hand) {
+      counts[c]++;
+    }
+    int wild = jokers ? std::exchange(counts['J'], 0) : 0;
+
+    std::vector<int> groups;
+    for (auto [card, count] : counts) {
+      if (count > 0) {
+        groups.push_back(count);
+      }
+    }
+    std::ranges::sort(groups, std::greater());
+    if (groups.empty()) {
+      groups.push_back(0);
+    }
+    groups[0] += wild;
+
+    std::vector<int> key = groups;
+    key.resize(5);
+    for (auto c : hand) {
+      key.push_back(static_cast<int>(order.find(c)));
+    }
+    return key;
+  };
+
+  std::set<std::string> seen;
+  std::vector<std::pair<std::string, long>> dealt;
+  while (static_cast<long>(dealt.size()) < options.size) {
+    std::string hand(5, ' ');
+    for (auto &c : hand) {
+      c = faces[rng.between(0, 12)];
+    }
+    if (seen.insert(hand).second) {
+      dealt.emplace_back(hand, rng.between(1, 1000));
+    }
+  }
+
+  for (const auto &[hand, bid] : dealt) {
+    out << hand << ' ' << bid << '\n';
+  }
+
+  auto winnings = [&](std::string_view order, bool jokers) {
+    std::vector<std::pair<std::vector<int>, long>> ranked;
+    for (const auto &[hand, bid] : dealt) {
+      ranked.emplace_back(strength(hand, order, jokers), bid);
+    }
+    std::ranges::sort(ranked);
+
+    __int128 total = 0;
+    for (std::size_t i = 0; i < ranked.size(); ++i) {
+      total += ranked[i].second * static_cast<__int128>(i + 1);
+    }
+    return fits_long(total);
+  };
+
+  return {winnings(faces, false), winnings(joker_faces, true)};
+}
+
+void usage() {
+  std::cerr
+      << "usage: gen DAY [--size N] [--seed S] [--answers FILE]\n"
+         "              [--width W] [--height H] [--density D]\n"
+         "              [--stages N] [--entries M]\n"
+         "\n"
+         "Writes a valid input for day 01-07 to stdout. --size counts lines\n"
+         "(01), games (02), cards (04), seeds (05), races (06) or hands (07);\n"
+         "03 uses --width, --height and the symbol --density, and 05 uses\n"
+         "--stages maps of --entries entries. --answers writes the expected\n"
+         "answers as JSON.\n";
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+
+  std::string day = argv[1];
+  Options options;
+  std::string answers_path;
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string_view arg = argv[i];
+    std::string value = argv[i + 1];
+    if (arg == "--size") {
+      options.size = std::stol(value);
+    } else if (arg == "--seed") {
+      options.seed = std::stoull(value);
+    } else if (arg == "--width") {
+      options.width = std::stoi(value);
+    } else if (arg == "--height") {
+      options.height = std::stoi(value);
+    } else if (arg == "--density") {
+      options.density = std::stod(value);
+    } else if (arg == "--stages") {
+      options.stages = std::stoi(value);
+    } else if (arg == "--entries") {
+      options.entries = std::stoi(value);
+    } else if (arg == "--answers") {
+      answers_path = value;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (argc % 2 != 0) {
+    usage();
+    return 1;
+  }
+
+  using generator = Answers (*)(std::ostream &, const Options &, Random &);
+  const std::map<std::string, generator> generators = {
+      {"01", calibration}, {"02", games}, {"03", schematic},
+      {"04", scratchcards}, {"05", almanac}, {"06", races}, {"07", hands},
+  };
+
+  auto it = generators.find(day);
+  if (it == generators.end()) {
+    usage();
+    return 1;
+  }
+
+  Random rng(options.seed);
+  std::ostringstream out;
+  auto answers = it->second(out, options, rng);
+  std::cout << out.str();
+
+  if (!answers_path.empty()) {
+    auto json = [](const std::optional<long> &v) {
+      return v ? std::to_string(*v) : std::string("null");
+    };
+
+    std::ofstream file(answers_path);
+    file << "{\"day\":\"" << day << "\",\"part1\":" << json(answers.part1)
+         << ",\"part2\":" << json(answers.part2) << "}" << std::endl;
+  }
+}
@@ -0,0 +1,56 @@
+#include "../01/calibration.hpp"
+#include "../06/constant.hpp"
+#include "../06/lib.hpp"
+#include "../07/constant.hpp"
+#include "../07/lib.hpp"
+
+// generated from each day's input by common/embed.cmake
+#include "day01.hpp"
+#include "day06.hpp"
+#include "day07.hpp"
+
+#include <iostream>
+
+// Answers for the committed inputs, worked out by the compiler. Printing them
+// costs nothing at run time; checking them against the run time solvers
+// catches either side drifting.
+namespace {
+namespace embedded = aoc::embedded;
+
+constexpr long day01_part1 = day01::part1(embedded::day01);
+constexpr long day01_part2 = day01::part2(embedded::day01);
+
+constexpr auto sheet =
+    day06::constant::parse<day06::constant::columns(embedded::day06)>(
+        embedded::day06);
+constexpr long day06_part1 = day06::constant::part1(sheet);
+constexpr long day06_part2 = day06::constant::part2(sheet);
+
+constexpr auto deals =
+    day07::constant::parse<day07::constant::count(embedded::day07)>(
+        embedded::day07);
+constexpr long day07_part1 = day07::constant::part1(deals);
+constexpr long day07_part2 = day07::constant::part2(deals);
+
+// `expected` is the run time solver's answer, or a known one
+bool check(const char *day, const char *part, long golden, long expected) {
+  std::cout << day << " part" << part << ": " << golden << std::endl;
+  if (golden != expected) {
+    std::cerr << day << " part" << part << " should be " << expected
+              << std::endl;
+  }
+  return golden == expected;
+}
+} // namespace
+
+int main() {
+  // 01 has no separate run time solver, so its answers are held to the ones
+  // submitted for the committed input instead
+  bool ok = check("01", "1", day01_part1, 54390);
+  ok &= check("01", "2", day01_part2, 54277);
+  ok &= check("06", "1", day06_part1, day06::part1(embedded::day06));
+  ok &= check("06", "2", day06_part2, day06::part2(embedded::day06));
+  ok &= check("07", "1", day07_part1, day07::part1(embedded::day07));
+  ok &= check("07", "2", day07_part2, day07::part2(embedded::day07));
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include "../bench/bench.hpp"
+#include "../common/input.hpp"
+#include "../common/wire.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <semaphore>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Options {
+  std::string socket;
+  std::string day;
+  std::string part;
+  std::string path;
+  long requests = 1000;
+  long inflight = 16;
+};
+
+void usage() {
+  std::cerr << "usage: loadgen SOCKET DAY PART PATH [--requests N] "
+               "[--inflight N]\n"
+               "\n"
+               "Sends PATH to `aoc serve` as N requests for DAY PART over one\n"
+               "connection, keeping up to --inflight of them outstanding, and\n"
+               "reports the latency of each round trip as a bench result:\n"
+               "one JSON line with the median, p90 and p99.\n";
+}
+
+std::int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 5) {
+    usage();
+    return 1;
+  }
+
+  Options options{argv[1], argv[2], argv[3], argv[4]};
+  for (int i = 5; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--requests" && i + 1 < argc) {
+      options.requests = std::max(1L, std::stol(argv[++i]));
+    } else if (arg == "--inflight" && i + 1 < argc) {
+      options.inflight = std::max(1L, std::stol(argv[++i]));
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  aoc::mapped_file file(options.path);
+  if (!file.is_open()) {
+    std::cerr << "could not open " << options.path << std::endl;
+    return 1;
+  }
+
+  try {
+    auto socket = aoc::wire::socket::connect(options.socket);
+
+    // send times by request id, read back when the reply arrives
+    std::vector<std::atomic<std::int64_t>> sent(options.requests);
+    std::counting_semaphore<> slots(options.inflight);
+    std::jthread sender([&](std::stop_token stop) {
+      aoc::wire::request request{0, options.day, options.part,
+                                 std::string(file.view())};
+      try {
+        for (long id = 0; id < options.requests; ++id) {
+          slots.acquire();
+          if (stop.stop_requested()) {
+            break;
+          }
+          request.id = id;
+          sent[id] = now_ns();
+          aoc::wire::write_request(socket, request);
+        }
+      } catch (const std::exception &e) {
+        std::cerr << "sending: " << e.what() << std::endl;
+      }
+      socket.finish();
+    });
+    // however the reader leaves, the sender mustn't be left waiting on a slot,
+    // or joining it would never return
+    struct release_sender {
+      std::jthread &sender;
+      std::counting_semaphore<> &slots;
+      long requests;
+      ~release_sender() {
+        sender.request_stop();
+        slots.release(requests);
+      }
+    } release{sender, slots, options.requests};
+
+    bench::Result latency{"serve/" + options.day + "/" + options.part,
+                          file.view().size() * options.requests,
+                          static_cast<std::size_t>(options.requests),
+                          {}};
+    std::vector<double> parse, solve;
+    long failed = 0;
+    auto start = now_ns();
+    while (auto reply = aoc::wire::read_response(socket)) {
+      if (reply->id >= sent.size()) {
+        throw std::runtime_error("reply to unknown request " +
+                                 std::to_string(reply->id));
+      }
+      latency.samples.push_back(now_ns() - sent[reply->id]);
+      slots.release();
+      if (!reply->answer) {
+        if (failed++ == 0) {
+          std::cerr << "request failed: " << reply->error << std::endl;
+        }
+        continue;
+      }
+      parse.push_back(reply->parse_ns);
+      solve.push_back(reply->solve_ns);
+    }
+    double elapsed = now_ns() - start;
+
+    if (static_cast<long>(latency.samples.size()) != options.requests) {
+      std::cerr << "server closed the connection after "
+                << latency.samples.size() << " replies" << std::endl;
+      return 1;
+    }
+
+    std::ranges::sort(latency.samples);
+    bench::report(std::cout, latency);
+
+    std::cerr << options.requests << " requests, " << options.inflight
+              << " in flight: " << options.requests / elapsed * 1e9
+              << " per second, p50 " << bench::percentile(latency, 50) / 1e3
+              << " us, p99 " << bench::percentile(latency, 99) / 1e3 << " us";
+    if (!parse.empty()) {
+      std::ranges::sort(parse);
+      std::ranges::sort(solve);
+      std::cerr << " (server p50: parse " << parse[parse.size() / 2] / 1e3
+                << " us, solve " << solve[solve.size() / 2] / 1e3 << " us)";
+    }
+    std::cerr << std::endl;
+
+    if (failed > 0) {
+      std::cerr << failed << " requests failed" << std::endl;
+      return 1;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
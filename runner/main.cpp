@@ -0,0 +1,904 @@
+#include "../01/calibration.hpp"
+#include "../02/lib.hpp"
+#include "../03/lib.hpp"
+#include "../04/lib.hpp"
+#include "../05/lib.hpp"
+#include "../06/lib.hpp"
+#include "../07/lib.hpp"
+#include "../bench/bench.hpp"
+#include "../common/alloc.hpp"
+#include "../common/arena.hpp"
+#include "../common/cache.hpp"
+#include "../common/input.hpp"
+#include "../common/instrument.hpp"
+#include "../common/pool.hpp"
+#include "../common/snapshot.hpp"
+#include "../common/wire.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+// One solver per part, all sharing a single parsed model.
+using Bound = std::vector<std::function<long()>>;
+
+struct Day {
+  std::string_view name;
+  // keys the day's cached answers
+  int version;
+  std::vector<std::string_view> parts;
+  // Parses the input into the arena and binds every part's solver to the
+  // result, in the order of `parts`. The arena must outlive the solvers.
+  std::function<Bound(std::string_view, aoc::arena &)> parse;
+  // The same for a snapshot of the model, which is used in place. Days
+  // without a snapshot format leave it empty.
+  std::function<Bound(std::string_view)> load;
+};
+
+template <typename Model>
+using Part = std::pair<std::string_view, long (*)(const Model &)>;
+
+template <typename Model>
+Day make_day(std::string_view name, int version,
+             Model (*parse)(std::string_view, aoc::arena &),
+             std::vector<Part<Model>> parts) {
+  Day day{name, version, {}, {}, {}};
+  for (const auto &part : parts) {
+    day.parts.push_back(part.first);
+  }
+
+  day.parse = [parse, parts](std::string_view input, aoc::arena &arena) {
+    auto model = std::make_shared<const Model>(parse(input, arena));
+    Bound bound;
+    for (auto solve : parts | std::views::values) {
+      bound.emplace_back([model, solve] { return solve(*model); });
+    }
+    return bound;
+  };
+
+  return day;
+}
+
+// Lets a day solve a snapshot, given one solver per part in the same order.
+template <typename View>
+Day with_snapshot(Day day, View (*load)(std::string_view),
+                  std::vector<long (*)(const View &)> parts) {
+  day.load = [load, parts](std::string_view snapshot) {
+    auto view = std::make_shared<const View>(load(snapshot));
+    Bound bound;
+    for (auto solve : parts) {
+      bound.emplace_back([view, solve] { return solve(*view); });
+    }
+    return bound;
+  };
+
+  return day;
+}
+
+const std::vector<Day> days = {
+    // the model is a copy of the text, kept in the arena like any other
+    make_day<std::pmr::string>(
+        "01", day01::version,
+        [](std::string_view input, aoc::arena &arena) {
+          return std::pmr::string(input, arena.allocator());
+        },
+        {{"1", [](const auto &m) -> long { return day01::part1(m); }},
+         {"2", [](const auto &m) -> long { return day01::part2(m); }}}),
+    make_day<day02::Games>(
+        "02", day02::version, day02::parse,
+        {{"1", [](const auto &m) -> long { return day02::part1(m); }},
+         {"2", [](const auto &m) -> long { return day02::part2(m); }}}),
+    // snap writes the schematic's grid, which parse reads as well as text
+    with_snapshot<day03::Schematic>(
+        make_day<day03::Schematic>(
+            "03", day03::version,
+            [](std::string_view input, aoc::arena &) {
+              return day03::parse(input);
+            },
+            {{"1", [](const auto &m) -> long { return day03::part1(m); }},
+             {"2", [](const auto &m) -> long { return day03::part2(m); }}}),
+        day03::parse,
+        {[](const auto &m) -> long { return day03::part1(m); },
+         [](const auto &m) -> long { return day03::part2(m); }}),
+    with_snapshot<day04::Matches>(
+        make_day<day04::Cards>(
+            "04", day04::version, day04::parse,
+            {{"1", [](const auto &m) -> long { return day04::part1(m); }},
+             {"2", [](const auto &m) -> long { return day04::part2(m); }},
+             {"2-cooler",
+              [](const auto &m) -> long { return day04::part2_cooler(m); }}}),
+        day04::load,
+        {[](const auto &m) -> long { return day04::part1(m); },
+         [](const auto &m) -> long { return day04::part2(m); },
+         [](const auto &m) -> long { return day04::part2_cooler(m); }}),
+    with_snapshot<day05::Stages>(
+        make_day<day05::Almanac>(
+            "05", day05::version, day05::parse,
+            {{"1", [](const auto &m) -> long { return day05::part1(m); }},
+             {"2", [](const auto &m) -> long { return day05::part2(m); }}}),
+        day05::load,
+        {[](const auto &m) -> long { return day05::part1(m); },
+         [](const auto &m) -> long { return day05::part2(m); }}),
+    make_day<day06::Races>(
+        "06", day06::version, day06::parse,
+        {{"1", [](const auto &m) -> long { return day06::part1(m); }},
+         {"2", [](const auto &m) -> long { return day06::part2(m); }}}),
+    with_snapshot<day07::Rankings>(
+        make_day<day07::Deals>(
+            "07", day07::version, day07::parse,
+            {{"1", [](const auto &m) -> long { return day07::part1(m); }},
+             {"2", [](const auto &m) -> long { return day07::part2(m); }}}),
+        day07::load,
+        {[](const auto &m) -> long { return day07::part1(m); },
+         [](const auto &m) -> long { return day07::part2(m); }}),
+};
+
+// Parses text input, or loads a snapshot (see common/snapshot.hpp) in place.
+Bound bind_parts(const Day &day, std::string_view input, aoc::arena &arena) {
+  if (!aoc::snapshot::is_snapshot(input)) {
+    return day.parse(input, arena);
+  }
+  if (!day.load) {
+    throw std::runtime_error("day " + std::string(day.name) +
+                             " has no snapshot format");
+  }
+  return day.load(input);
+}
+
+struct Run {
+  std::string_view part;
+  long answer = 0;
+  bench::Result result;
+  std::exception_ptr error;
+};
+
+void print(std::ostream &out, const aoc::alloc::stats &used) {
+  out << "{\"count\":" << used.count << ",\"bytes\":" << used.bytes
+      << ",\"peak\":" << used.peak << '}';
+}
+
+void print(std::ostream &out, const bench::Result &result) {
+  double mean = 0;
+  for (auto sample : result.samples) {
+    mean += sample / result.samples.size();
+  }
+
+  out << "{\"min\":" << result.samples.front()
+      << ",\"median\":" << bench::percentile(result, 50)
+      << ",\"mean\":" << mean
+      << ",\"p90\":" << bench::percentile(result, 90)
+      << ",\"max\":" << result.samples.back() << '}';
+}
+
+void summarize(std::ostream &out, std::string_view what,
+               const bench::Result &result) {
+  out << what << ": " << bench::percentile(result, 50) / 1e6
+      << " ms median of " << result.samples.size() << " (min "
+      << result.samples.front() / 1e6 << ", max "
+      << result.samples.back() / 1e6 << ")" << std::endl;
+}
+
+double since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void usage() {
+  std::cerr
+      << "usage: aoc DAY PART[,PART...]|all [PATH|-] [--repeat N] [--json]\n"
+         "           [--profile] [--counters] [--no-cache]\n"
+         "       aoc batch DIR|MANIFEST [--parts PART[,PART...]]\n"
+         "           [--threads N] [--json] [--no-cache]\n"
+         "       aoc serve SOCKET [--threads N]\n"
+         "\n"
+         "Solves parts of one day, reading PATH or stdin. The input is parsed\n"
+         "once and each part then runs on its own thread against the shared\n"
+         "model. Reports wall times for reading, parsing and each part.\n"
+         "\n"
+         "--profile reports the solver's instrumented scopes, and --counters\n"
+         "adds hardware counters to them; both need -DAOC_INSTRUMENT=ON.\n"
+         "Builds with -DAOC_TRACK_ALLOC=ON also report allocations.\n"
+         "\n"
+         "With AOC_CACHE naming a directory, answers are kept there by a\n"
+         "hash of the input and a repeated input skips parsing and solving.\n"
+         "--no-cache, --repeat and --profile always solve.\n"
+         "\n"
+         "Any PATH may be a snapshot written by snap, which is solved in\n"
+         "place without parsing.\n"
+         "\n"
+         "batch solves many inputs in one process. A manifest lists one\n"
+         "\"DAY PATH\" per line, relative to the manifest; a directory is\n"
+         "searched for NN/input files and files named NN.* or NN-*. Each\n"
+         "file is parsed once and its parts run as separate jobs on a\n"
+         "work-stealing pool, with results printed as they finish.\n"
+         "\n"
+         "serve stays up and answers requests on a Unix socket, so repeated\n"
+         "small inputs skip process startup and find the solvers' tables\n"
+         "and the pool already warm. See common/wire.hpp for the protocol\n"
+         "and loadgen for a client that measures its latency.\n"
+         "\n"
+         "solvers:\n";
+  for (const auto &day : days) {
+    std::cerr << "  " << day.name << ':';
+    for (auto part : day.parts) {
+      std::cerr << ' ' << part;
+    }
+    std::cerr << '\n';
+  }
+  std::cerr << std::flush;
+}
+// Writes s as a JSON string.
+void quoted(std::ostream &out, std::string_view s) {
+  out << '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (c == '\n') {
+      out << "\\n";
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+struct Job {
+  const Day *day;
+  std::filesystem::path path;
+};
+
+// The day an input belongs to, from a path like 04/input or acme/07-big.txt.
+const Day *day_of(const std::filesystem::path &path) {
+  auto owner = [](const std::string &name) -> const Day * {
+    for (const auto &day : days) {
+      if (name.starts_with(day.name) &&
+          (name.size() == day.name.size() ||
+           !std::isdigit(static_cast<unsigned char>(name[day.name.size()])))) {
+        return &day;
+      }
+    }
+    return nullptr;
+  };
+
+  if (path.filename() == "input") {
+    return owner(path.parent_path().filename().string());
+  }
+  return owner(path.filename().string());
+}
+
+std::vector<Job> discover(const std::filesystem::path &source) {
+  namespace fs = std::filesystem;
+  std::vector<Job> jobs;
+  if (fs::is_directory(source)) {
+    for (const auto &entry : fs::recursive_directory_iterator(source)) {
+      if (!entry.is_regular_file()) {
+        continue;
+      }
+      if (const auto *day = day_of(entry.path())) {
+        jobs.push_back({day, entry.path()});
+      }
+    }
+
+    std::ranges::sort(jobs, {}, &Job::path);
+    return jobs;
+  }
+
+  std::ifstream manifest(source);
+  if (!manifest.is_open()) {
+    throw std::runtime_error("could not open " + source.string());
+  }
+
+  for (auto line : aoc::getlines(manifest)) {
+    auto start = line.find_first_not_of(' ');
+    if (start == std::string_view::npos || line[start] == '#') {
+      continue;
+    }
+
+    line.remove_prefix(start);
+    auto space = line.find(' ');
+    auto name = line.substr(0, space);
+    auto day = std::ranges::find(days, name, &Day::name);
+    auto rest = space == std::string_view::npos ? std::string_view()
+                                                : line.substr(space + 1);
+    rest.remove_prefix(std::min(rest.find_first_not_of(' '), rest.size()));
+    if (day == days.end() || rest.empty()) {
+      throw std::runtime_error("bad manifest line: " + std::string(line));
+    }
+
+    jobs.push_back({&*day, source.parent_path() / rest});
+  }
+
+  return jobs;
+}
+
+int batch(int argc, char **argv) {
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+
+  std::filesystem::path source = argv[2];
+  std::vector<std::string_view> wanted;
+  unsigned threads = 0;
+  bool json = false;
+  bool use_cache = true;
+  for (int i = 3; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--no-cache") {
+      use_cache = false;
+    } else if (arg == "--parts" && i + 1 < argc) {
+      for (auto part : std::views::split(std::string_view(argv[++i]), ',')) {
+        wanted.emplace_back(part.begin(), part.end());
+      }
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    } else if (arg == "--json") {
+      json = true;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  std::vector<Job> jobs;
+  try {
+    jobs = discover(source);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  auto cache = use_cache ? aoc::cache::store::from_env() : std::nullopt;
+
+  std::mutex out_lock;
+  auto emit = [&](const Job &job, std::string_view part, long answer,
+                  double ns, const std::string &error) {
+    std::lock_guard lock(out_lock);
+    if (json) {
+      std::cout << "{\"path\":";
+      quoted(std::cout, job.path.string());
+      std::cout << ",\"day\":\"" << job.day->name << "\",\"part\":\"" << part
+                << '"';
+      if (error.empty()) {
+        std::cout << ",\"answer\":" << answer << ",\"ns\":" << ns;
+      } else {
+        std::cout << ",\"error\":";
+        quoted(std::cout, error);
+      }
+      std::cout << '}' << std::endl;
+    } else if (error.empty()) {
+      std::cout << job.path.string() << ' ' << job.day->name << ' ' << part
+                << ": " << answer << std::endl;
+    } else {
+      std::cout << job.path.string() << ' ' << job.day->name << ' ' << part
+                << ": error: " << error << std::endl;
+    }
+  };
+
+  // time spent inside jobs, against wall time across every thread
+  std::atomic<double> busy_ns = 0;
+  std::atomic<std::size_t> solved = 0, cached = 0, failed = 0;
+  auto start = std::chrono::steady_clock::now();
+  aoc::work_pool pool(threads);
+  for (const auto &job : jobs) {
+    pool.submit([&, job] {
+      auto began = std::chrono::steady_clock::now();
+      auto file = std::make_shared<aoc::mapped_file>(job.path.string());
+      if (!file->is_open()) {
+        emit(job, "parse", 0, 0, "could not open file");
+        ++failed;
+        busy_ns += since(began);
+        return;
+      }
+
+      // parts with a cached answer are done without parsing at all
+      aoc::cache::key key{job.day->name, {}, job.day->version, 0,
+                          file->view().size()};
+      if (cache) {
+        key.input = aoc::cache::hash(file->view());
+      }
+      std::vector<std::size_t> parts;
+      for (std::size_t i = 0; i < job.day->parts.size(); ++i) {
+        key.part = job.day->parts[i];
+        if (!wanted.empty() &&
+            std::ranges::find(wanted, key.part) == wanted.end()) {
+          continue;
+        }
+
+        if (auto answer = cache ? cache->get(key) : std::nullopt) {
+          emit(job, key.part, *answer, 0, {});
+          ++cached;
+        } else {
+          parts.push_back(i);
+        }
+      }
+      if (parts.empty()) {
+        busy_ns += since(began);
+        return;
+      }
+
+      auto arena = std::make_shared<aoc::arena>();
+      Bound bound;
+      try {
+        bound = bind_parts(*job.day, file->view(), *arena);
+      } catch (const std::exception &e) {
+        emit(job, "parse", 0, 0, e.what());
+        ++failed;
+        busy_ns += since(began);
+        return;
+      }
+      busy_ns += since(began);
+
+      // the parts share the model, so each holds on to the file and arena
+      for (auto i : parts) {
+        key.part = job.day->parts[i];
+        pool.submit([&, job, key, file, arena, solve = bound[i]] {
+          auto began = std::chrono::steady_clock::now();
+          try {
+            auto answer = solve();
+            auto ns = since(began);
+            emit(job, key.part, answer, ns, {});
+            ++solved;
+            if (cache) {
+              cache->put(key, answer);
+            }
+          } catch (const std::exception &e) {
+            emit(job, key.part, 0, 0, e.what());
+            ++failed;
+          }
+          busy_ns += since(began);
+        });
+      }
+    });
+  }
+  pool.wait();
+
+  double wall = since(start);
+  std::cerr << jobs.size() << " files, " << solved << " parts solved";
+  if (cached > 0) {
+    std::cerr << ", " << cached << " cached";
+  }
+  if (failed > 0) {
+    std::cerr << ", " << failed << " failed";
+  }
+  std::cerr << " in " << wall / 1e6 << " ms on " << pool.size()
+            << " threads (" << 100 * busy_ns / (wall * pool.size())
+            << "% busy)" << std::endl;
+  return failed > 0 ? 1 : 0;
+}
+
+aoc::wire::response answer(const aoc::wire::request &request) {
+  aoc::wire::response out{request.id, std::nullopt, 0, 0, {}};
+  auto day = std::ranges::find(days, request.day, &Day::name);
+  if (day == days.end()) {
+    out.error = "no solver for day " + request.day;
+    return out;
+  }
+
+  auto part = std::ranges::find(day->parts, request.part);
+  if (part == day->parts.end()) {
+    out.error = "day " + request.day + " has no part " + request.part;
+    return out;
+  }
+
+  try {
+    aoc::arena arena;
+    auto start = std::chrono::steady_clock::now();
+    auto bound = bind_parts(*day, request.input, arena);
+    out.parse_ns = since(start);
+
+    start = std::chrono::steady_clock::now();
+    out.answer = bound[part - day->parts.begin()]();
+    out.solve_ns = since(start);
+  } catch (const std::exception &e) {
+    out.error = e.what();
+  }
+
+  return out;
+}
+
+// One client of `aoc serve`. Its requests are read on a thread of their own
+// and solved on the pool, and each reply is written as soon as it's ready,
+// so a slow request doesn't hold up those behind it.
+struct Connection {
+  aoc::wire::socket socket;
+  std::mutex write_lock;
+  // set by the reader as it returns, so the thread can be joined
+  std::atomic<bool> done = false;
+};
+
+// The connections serve has open, each with the thread reading it. Going out
+// of scope shuts every socket down, so the readers return and are joined.
+class Connections {
+public:
+  Connections() = default;
+  Connections(const Connections &) = delete;
+  Connections &operator=(const Connections &) = delete;
+
+  ~Connections() {
+    for (auto &[connection, reader] : this->open) {
+      connection->socket.shutdown();
+    }
+  }
+
+  template <typename F>
+  void add(std::shared_ptr<Connection> connection, F &&read) {
+    // joins the readers of clients that have gone
+    std::erase_if(this->open, [](const auto &entry) {
+      return entry.first->done.load();
+    });
+    this->open.emplace_back(connection, std::jthread(std::forward<F>(read)));
+  }
+
+private:
+  std::list<std::pair<std::shared_ptr<Connection>, std::jthread>> open;
+};
+
+int serve(int argc, char **argv) {
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+
+  std::string path = argv[2];
+  unsigned threads = 0;
+  for (int i = 3; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  try {
+    auto listener = aoc::wire::socket::listen(path);
+    // The pool outlives the connections, whose readers submit to it, and
+    // finishes their jobs before it goes.
+    aoc::work_pool pool(threads);
+    Connections connections;
+    std::cerr << "listening on " << path << " with " << pool.size()
+              << " threads" << std::endl;
+
+    while (true) {
+      auto connection = std::make_shared<Connection>(listener.accept());
+      connections.add(connection, [&pool, connection] {
+        try {
+          while (auto request = aoc::wire::read_request(connection->socket)) {
+            auto shared = std::make_shared<const aoc::wire::request>(
+                std::move(*request));
+            pool.submit([connection, shared] {
+              auto reply = answer(*shared);
+              std::lock_guard lock(connection->write_lock);
+              try {
+                aoc::wire::write_response(connection->socket, reply);
+              } catch (const std::exception &) {
+                // the client hung up without waiting for its answers
+              }
+            });
+          }
+        } catch (const std::exception &e) {
+          std::cerr << "dropping connection: " << e.what() << std::endl;
+        }
+        connection->done = true;
+      });
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc >= 2 && std::string_view(argv[1]) == "batch") {
+    return batch(argc, argv);
+  }
+  if (argc >= 2 && std::string_view(argv[1]) == "serve") {
+    return serve(argc, argv);
+  }
+
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+
+  std::string_view name = argv[1], selection = argv[2];
+  std::string path = "-";
+  int repeat = 1;
+  bool json = false;
+  bool profile = false;
+  bool use_cache = true;
+  for (int i = 3; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--json") {
+      json = true;
+    } else if (arg == "--no-cache") {
+      use_cache = false;
+    } else if (arg == "--profile") {
+      profile = true;
+    } else if (arg == "--counters") {
+      profile = true;
+#ifdef AOC_INSTRUMENT
+      aoc::instrument::enable_counters();
+#endif
+    } else if (arg.starts_with("--")) {
+      usage();
+      return 1;
+    } else {
+      path = arg;
+    }
+  }
+
+#ifndef AOC_INSTRUMENT
+  if (profile) {
+    std::cerr << "note: built without AOC_INSTRUMENT, no scopes to report"
+              << std::endl;
+    profile = false;
+  }
+#endif
+
+  auto day = std::ranges::find(days, name, &Day::name);
+  if (day == days.end()) {
+    usage();
+    return 1;
+  }
+
+  // indices into day->parts, in the order asked for
+  std::vector<std::size_t> selected;
+  if (selection == "all") {
+    for (std::size_t i = 0; i < day->parts.size(); ++i) {
+      selected.push_back(i);
+    }
+  } else {
+    for (auto part : std::views::split(selection, ',')) {
+      auto found = std::ranges::find(
+          day->parts, std::string_view(part.begin(), part.end()));
+      if (found == day->parts.end()) {
+        usage();
+        return 1;
+      }
+      selected.push_back(found - day->parts.begin());
+    }
+  }
+
+  // the mapping is lazy, so page faults land in the parse phase; stdin has
+  // to be copied in up front
+  std::optional<aoc::alloc::phase> phase(std::in_place);
+  auto start = std::chrono::steady_clock::now();
+  std::optional<aoc::mapped_file> file;
+  std::string buffer;
+  std::string_view input;
+  if (path == "-") {
+    auto it = std::istreambuf_iterator(std::cin);
+    buffer.assign(it, {});
+    input = buffer;
+  } else {
+    file.emplace(path);
+    if (!file->is_open()) {
+      std::cerr << "could not open " << path << std::endl;
+      return 1;
+    }
+    input = file->view();
+  }
+  double read_ns = since(start);
+  auto read_allocs = phase->stats();
+
+  // answers for an input seen before come from the cache, unless the run is
+  // there to measure the solvers
+  std::optional<aoc::cache::store> cache;
+  if (use_cache && repeat == 1 && !profile) {
+    cache = aoc::cache::store::from_env();
+  }
+  std::uint64_t digest = 0;
+  auto key = [&](std::size_t part) {
+    return aoc::cache::key{day->name, day->parts[part], day->version, digest,
+                           input.size()};
+  };
+  if (cache) {
+    start = std::chrono::steady_clock::now();
+    digest = aoc::cache::hash(input);
+    std::vector<long> answers;
+    for (auto part : selected) {
+      auto answer = cache->get(key(part));
+      if (!answer) {
+        break;
+      }
+      answers.push_back(*answer);
+    }
+    double lookup_ns = since(start);
+
+    if (answers.size() == selected.size()) {
+      if (json) {
+        std::cout << "{\"day\":\"" << name << "\",\"bytes\":" << input.size()
+                  << ",\"read_ns\":" << read_ns
+                  << ",\"cached\":true,\"lookup_ns\":" << lookup_ns
+                  << ",\"parts\":[";
+        for (std::size_t i = 0; i < selected.size(); ++i) {
+          std::cout << (i == 0 ? "" : ",") << "{\"part\":\""
+                    << day->parts[selected[i]]
+                    << "\",\"answer\":" << answers[i] << '}';
+        }
+        std::cout << "]}" << std::endl;
+      } else {
+        for (std::size_t i = 0; i < selected.size(); ++i) {
+          if (selected.size() > 1) {
+            std::cout << day->parts[selected[i]] << ": ";
+          }
+          std::cout << answers[i] << std::endl;
+        }
+        std::cerr << "read: " << read_ns / 1e6 << " ms" << std::endl;
+        std::cerr << "cached: " << lookup_ns / 1e6 << " ms to hash and look up"
+                  << std::endl;
+      }
+      return 0;
+    }
+  }
+
+  // a failed parse or part is reported like batch reports one
+  auto report = [&](std::string_view part, std::exception_ptr error) {
+    std::string message = "unknown error";
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::exception &e) {
+      message = e.what();
+    } catch (...) {
+    }
+
+    if (json) {
+      std::cout << "{\"day\":\"" << name << "\",\"part\":\"" << part
+                << "\",\"error\":";
+      quoted(std::cout, message);
+      std::cout << '}' << std::endl;
+    } else {
+      std::cout << name << ' ' << part << ": error: " << message << std::endl;
+    }
+  };
+
+  // every repetition parses into a fresh arena; the last model is the one
+  // the parts solve, and allocations are reported for that parse alone
+  std::unique_ptr<aoc::arena> arena;
+  Bound bound;
+  aoc::alloc::stats parse_allocs;
+  bench::Result parsed;
+  try {
+    parsed = bench::measure(std::string(name) + "/parse",
+                            {.warmup = 0, .reps = repeat}, input.size(), 0,
+                            [&] {
+                              bound.clear();
+                              arena = std::make_unique<aoc::arena>();
+                              phase.emplace();
+                              bound = bind_parts(*day, input, *arena);
+                              parse_allocs = phase->stats();
+                              return bound.size();
+                            });
+  } catch (...) {
+    report("parse", std::current_exception());
+    return 1;
+  }
+
+  // solve allocations cover every repetition of every part
+  std::vector<Run> runs(selected.size());
+  phase.emplace();
+  {
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < selected.size(); ++i) {
+      threads.emplace_back([&, i] {
+        auto &run = runs[i];
+        auto &solve = bound[selected[i]];
+        run.part = day->parts[selected[i]];
+        try {
+          run.result = bench::measure(
+              std::string(name) + "/" + std::string(run.part),
+              {.warmup = 0, .reps = repeat}, input.size(), 0,
+              [&] { return run.answer = solve(); });
+        } catch (...) {
+          run.error = std::current_exception();
+        }
+      });
+    }
+  }
+  auto solve_allocs = phase->stats();
+  phase.reset();
+
+  bool failed = false;
+  for (const auto &run : runs) {
+    if (run.error) {
+      report(run.part, run.error);
+      failed = true;
+    }
+  }
+  if (failed) {
+    return 1;
+  }
+  if (cache) {
+    for (std::size_t i = 0; i < selected.size(); ++i) {
+      cache->put(key(selected[i]), runs[i].answer);
+    }
+  }
+
+  if (json) {
+    std::cout << "{\"day\":\"" << name << "\",\"bytes\":" << input.size()
+              << ",\"repeat\":" << repeat << ",\"read_ns\":" << read_ns
+              << ",\"parse_ns\":";
+    print(std::cout, parsed);
+    std::cout << ",\"parts\":[";
+    for (bool first = true; const auto &run : runs) {
+      std::cout << (first ? "" : ",") << "{\"part\":\"" << run.part
+                << "\",\"answer\":" << run.answer << ",\"solve_ns\":";
+      print(std::cout, run.result);
+      std::cout << '}';
+      first = false;
+    }
+    std::cout << "],\"peak_rss\":" << aoc::alloc::peak_rss();
+    if (aoc::alloc::tracking()) {
+      std::cout << ",\"alloc\":{\"read\":";
+      print(std::cout, read_allocs);
+      std::cout << ",\"parse\":";
+      print(std::cout, parse_allocs);
+      std::cout << ",\"solve\":";
+      print(std::cout, solve_allocs);
+      std::cout << '}';
+    }
+#ifdef AOC_INSTRUMENT
+    if (profile) {
+      std::cout << ",\"scopes\":";
+      aoc::instrument::report(std::cout);
+    }
+#endif
+    std::cout << '}' << std::endl;
+  } else {
+    for (const auto &run : runs) {
+      if (runs.size() > 1) {
+        std::cout << run.part << ": ";
+      }
+      std::cout << run.answer << std::endl;
+    }
+
+    std::cerr << "read: " << read_ns / 1e6 << " ms" << std::endl;
+    summarize(std::cerr, "parse", parsed);
+    for (const auto &run : runs) {
+      summarize(std::cerr, "part " + std::string(run.part), run.result);
+    }
+    std::cerr << "peak rss: " << aoc::alloc::peak_rss() / 1024 << " KiB"
+              << std::endl;
+    if (aoc::alloc::tracking()) {
+      std::cerr << "allocations: read ";
+      print(std::cerr, read_allocs);
+      std::cerr << ", parse ";
+      print(std::cerr, parse_allocs);
+      std::cerr << ", solve ";
+      print(std::cerr, solve_allocs);
+      std::cerr << std::endl;
+    }
+#ifdef AOC_INSTRUMENT
+    if (profile) {
+      std::cerr << "scopes: ";
+      aoc::instrument::report(std::cerr);
+      std::cerr << std::endl;
+    }
+#endif
+  }
+}
@@ -0,0 +1,116 @@
+#include "../04/lib.hpp"
+#include "../05/lib.hpp"
+#include "../07/lib.hpp"
+#include "../common/arena.hpp"
+#include "../common/input.hpp"
+#include "../common/snapshot.hpp"
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace {
+// Parses a day's text input and writes its model as a snapshot.
+using Converter = std::function<std::string(std::string_view, aoc::arena &)>;
+
+const std::map<std::string_view, Converter> converters = {
+    {"03",
+     [](std::string_view input, aoc::arena &) {
+       return aoc::snapshot::write_grid("03", input);
+     }},
+    {"04",
+     [](std::string_view input, aoc::arena &arena) {
+       return day04::snapshot(day04::parse(input, arena));
+     }},
+    {"05",
+     [](std::string_view input, aoc::arena &arena) {
+       return day05::snapshot(day05::parse(input, arena));
+     }},
+    {"07",
+     [](std::string_view input, aoc::arena &arena) {
+       return day07::snapshot(day07::parse(input, arena));
+     }},
+};
+
+void usage() {
+  std::cerr << "usage: snap DAY INPUT|- OUTPUT\n"
+               "\n"
+               "Parses a text input and writes the model as a snapshot, which\n"
+               "aoc and the day's main read in place of the text. Snapshots\n"
+               "are tied to the day's version; convert again after bumping "
+               "it.\n"
+               "\n"
+               "days:";
+  for (const auto &day : converters) {
+    std::cerr << ' ' << day.first;
+  }
+  std::cerr << std::endl;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 4) {
+    usage();
+    return 1;
+  }
+
+  auto converter = converters.find(argv[1]);
+  if (converter == converters.end()) {
+    usage();
+    return 1;
+  }
+
+  std::string_view path = argv[2];
+  std::optional<aoc::mapped_file> file;
+  std::string buffer;
+  std::string_view input;
+  if (path == "-") {
+    auto it = std::istreambuf_iterator(std::cin);
+    buffer.assign(it, {});
+    input = buffer;
+  } else {
+    file.emplace(std::string(path));
+    if (!file->is_open()) {
+      std::cerr << "could not open " << path << std::endl;
+      return 1;
+    }
+    input = file->view();
+  }
+
+  std::string snapshot;
+  try {
+    aoc::arena arena;
+    snapshot = converter->second(input, arena);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  // written beside the output and renamed over it, so a reader never maps a
+  // partial snapshot
+  std::string output = argv[3];
+  auto staged = output + ".tmp";
+  {
+    std::ofstream out(staged, std::ios::binary | std::ios::trunc);
+    out.write(snapshot.data(), snapshot.size());
+    if (!out.flush()) {
+      std::cerr << "could not write " << staged << std::endl;
+      return 1;
+    }
+  }
+  if (std::rename(staged.c_str(), output.c_str()) != 0) {
+    std::cerr << "could not rename " << staged << " to " << output
+              << std::endl;
+    return 1;
+  }
+
+  std::cerr << input.size() << " bytes of input, " << snapshot.size()
+            << " bytes of snapshot" << std::endl;
+}